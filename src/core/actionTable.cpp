@@ -0,0 +1,143 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/actionTable.h"
+#include <cassert>
+#include <iterator>
+
+namespace giada::m
+{
+namespace
+{
+bool compareFrames_(const Action& a, const Action& b)
+{
+	return a.frame < b.frame;
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+const Action* ActionTable::find(ID id) const
+{
+	auto it = m_byId.find(id);
+	return it == m_byId.end() ? nullptr : &m_actions[it->second];
+}
+
+Action* ActionTable::find(ID id)
+{
+	return const_cast<Action*>(static_cast<const ActionTable*>(this)->find(id));
+}
+
+/* -------------------------------------------------------------------------- */
+
+ActionTable::View ActionTable::getFrame(Frame f) const
+{
+	auto [first, last] = std::equal_range(m_actions.begin(), m_actions.end(),
+	    Action{0, 0, f, {}}, compareFrames_);
+	return View(m_actions.data() + (first - m_actions.begin()),
+	    m_actions.data() + (last - m_actions.begin()));
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool ActionTable::hasChannel(ID channelId) const
+{
+	return m_byChannel.count(channelId) > 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionTable::clear()
+{
+	m_actions.clear();
+	m_byId.clear();
+	m_byChannel.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionTable::insert(const Action& a)
+{
+	auto it = std::upper_bound(m_actions.begin(), m_actions.end(), a, compareFrames_);
+	m_actions.insert(it, a);
+	reindex();
+}
+
+void ActionTable::insert(const std::vector<Action>& as)
+{
+	if (as.empty())
+		return;
+	/* Sort the new actions only, then merge them with the existing ones. */
+
+	const std::size_t mid = m_actions.size();
+	m_actions.insert(m_actions.end(), as.begin(), as.end());
+	std::stable_sort(m_actions.begin() + mid, m_actions.end(), compareFrames_);
+	std::inplace_merge(m_actions.begin(), m_actions.begin() + mid, m_actions.end(), compareFrames_);
+	reindex();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionTable::updateFrames(std::function<Frame(Frame old)> f)
+{
+	for (Action& a : m_actions)
+		a.frame = f(a.frame);
+	std::stable_sort(m_actions.begin(), m_actions.end(), compareFrames_);
+	reindex();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionTable::link()
+{
+	for (Action& a : m_actions)
+	{
+		a.prev = a.prevId != 0 ? find(a.prevId) : nullptr;
+		a.next = a.nextId != 0 ? find(a.nextId) : nullptr;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionTable::reindex()
+{
+	for (auto& [channelId, positions] : m_byChannel)
+		positions.clear();
+
+	for (std::size_t i = 0; i < m_actions.size(); i++)
+	{
+		m_byId[m_actions[i].id] = i;
+		m_byChannel[m_actions[i].channelId].push_back(i);
+	}
+
+	for (auto it = m_byChannel.begin(); it != m_byChannel.end();)
+		it = it->second.empty() ? m_byChannel.erase(it) : std::next(it);
+
+	link();
+}
+} // namespace giada::m
@@ -0,0 +1,172 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_ACTION_TABLE_H
+#define G_ACTION_TABLE_H
+
+#include "core/action.h"
+#include "core/types.h"
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace giada::m
+{
+/* ActionTable
+Stores all recorded actions in a single contiguous vector sorted by frame 
+(actions on the same frame keep their insertion order), plus two hash indexes:
+by action ID and by channel ID. Lookups by ID are O(1), per-channel queries 
+cost O(actions in channel). Edits cost a single linear pass to shift the
+vector and refresh indexes and prev/next pointers. 
+
+Action::prev and Action::next point inside the table and are kept valid across 
+edits and moves. For this reason the table can't be copied. */
+
+class ActionTable
+{
+public:
+	/* View
+	Read-only view of a contiguous run of actions. */
+
+	class View
+	{
+	public:
+		View() = default;
+		View(const Action* first, const Action* last)
+		: m_first(first)
+		, m_last(last)
+		{
+		}
+
+		const Action* begin() const { return m_first; }
+		const Action* end() const { return m_last; }
+		std::size_t   size() const { return m_last - m_first; }
+		bool          empty() const { return m_first == m_last; }
+
+	private:
+		const Action* m_first = nullptr;
+		const Action* m_last  = nullptr;
+	};
+
+	using const_iterator = std::vector<Action>::const_iterator;
+
+	ActionTable()                   = default;
+	ActionTable(const ActionTable&) = delete;
+	ActionTable(ActionTable&&)      = default;
+	ActionTable& operator=(const ActionTable&) = delete;
+	ActionTable& operator=(ActionTable&&) = default;
+
+	const_iterator begin() const { return m_actions.begin(); }
+	const_iterator end() const { return m_actions.end(); }
+	std::size_t    size() const { return m_actions.size(); }
+	bool           empty() const { return m_actions.empty(); }
+
+	/* find
+	Returns the action with ID 'id', or nullptr if not found. */
+
+	const Action* find(ID id) const;
+	Action*       find(ID id);
+
+	/* getFrame
+	Returns all actions recorded on frame 'f'. */
+
+	View getFrame(Frame f) const;
+
+	/* hasChannel
+	Tells whether channel 'channelId' has at least one action. */
+
+	bool hasChannel(ID channelId) const;
+
+	/* forEachOnChannel
+	Calls 'f(const Action&)' on each action of channel 'channelId', sorted by 
+	frame. */
+
+	template <typename F>
+	void forEachOnChannel(ID channelId, F&& f) const
+	{
+		auto it = m_byChannel.find(channelId);
+		if (it == m_byChannel.end())
+			return;
+		for (std::size_t i : it->second)
+			f(m_actions[i]);
+	}
+
+	void clear();
+
+	/* insert (1)
+	Adds a single action, after any other action on the same frame. */
+
+	void insert(const Action& a);
+
+	/* insert (2)
+	Adds a batch of actions: cheaper than inserting them one by one. */
+
+	void insert(const std::vector<Action>& as);
+
+	/* removeIf
+	Removes all actions for which 'f(const Action&)' returns true. */
+
+	template <typename F>
+	void removeIf(F&& f)
+	{
+		std::size_t last = 0;
+		for (std::size_t i = 0; i < m_actions.size(); i++)
+		{
+			if (f(static_cast<const Action&>(m_actions[i])))
+				m_byId.erase(m_actions[i].id);
+			else
+				m_actions[last++] = m_actions[i];
+		}
+		m_actions.resize(last);
+		reindex();
+	}
+
+	/* updateFrames
+	Moves each action to a new frame given by 'f(old)'. */
+
+	void updateFrames(std::function<Frame(Frame old)> f);
+
+	/* link
+	Refreshes prev/next pointers after prevId/nextId have been changed on 
+	actions already in the table. */
+
+	void link();
+
+private:
+	/* reindex
+	Rebuilds ID and channel indexes, then prev/next pointers. Existing index 
+	entries are overwritten in place to avoid reallocations. */
+
+	void reindex();
+
+	std::vector<Action>                              m_actions;
+	std::unordered_map<ID, std::size_t>              m_byId;
+	std::unordered_map<ID, std::vector<std::size_t>> m_byChannel;
+};
+} // namespace giada::m
+
+#endif
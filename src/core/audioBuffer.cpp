@@ -25,8 +25,11 @@
  * -------------------------------------------------------------------------- */
 
 #include "audioBuffer.h"
+#include "core/simd.h"
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <new>
 
 namespace giada::m
 {
@@ -60,6 +63,7 @@ AudioBuffer::AudioBuffer(float* data, Frame size, int channels)
 /* -------------------------------------------------------------------------- */
 
 AudioBuffer::AudioBuffer(const AudioBuffer& o)
+: AudioBuffer()
 {
 	copy(o);
 }
@@ -67,6 +71,7 @@ AudioBuffer::AudioBuffer(const AudioBuffer& o)
 /* -------------------------------------------------------------------------- */
 
 AudioBuffer::AudioBuffer(AudioBuffer&& o)
+: AudioBuffer()
 {
 	move(std::move(o));
 }
@@ -116,7 +121,7 @@ void AudioBuffer::clear(Frame a, Frame b)
 		return;
 	if (b == -1)
 		b = m_size;
-	std::fill_n(m_data + (a * m_channels), (b - a) * m_channels, 0.0);
+	std::fill_n(m_data + (a * m_channels), (b - a) * m_channels, 0.0f);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -130,10 +135,19 @@ bool  AudioBuffer::isAllocd() const { return m_data != nullptr; }
 
 float AudioBuffer::getPeak() const
 {
-	float peak = 0.0f;
+	if (m_data == nullptr)
+		return 0.0f;
+	return simd::get().getPeak(m_data, countSamples());
+}
+
+/* -------------------------------------------------------------------------- */
+
+float AudioBuffer::getMagnitude() const
+{
+	float magnitude = 0.0f;
 	for (int i = 0; i < countSamples(); i++)
-		peak = std::max(peak, m_data[i]);
-	return peak;
+		magnitude = std::max(magnitude, std::abs(m_data[i]));
+	return magnitude;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -145,7 +159,7 @@ void AudioBuffer::alloc(Frame size, int channels)
 	free();
 	m_size     = size;
 	m_channels = channels;
-	m_data     = new float[m_size * m_channels];
+	m_data     = allocData(m_size * m_channels);
 	clear();
 }
 
@@ -155,7 +169,8 @@ void AudioBuffer::free()
 {
 	if (m_data == nullptr)
 		return;
-	delete[] m_data;
+	if (!m_viewing)
+		freeData(m_data);
 	m_data     = nullptr;
 	m_size     = 0;
 	m_channels = 0;
@@ -206,19 +221,37 @@ void AudioBuffer::copyData(const AudioBuffer& b, Frame framesToCopy,
 	framesToCopy = framesToCopy == -1 ? b.countFrames() : framesToCopy;
 	framesToCopy = std::min(framesToCopy, m_size - destOffset);
 
+	framesToCopy = std::min(framesToCopy, b.countFrames());
+
+	if (framesToCopy <= 0)
+		return;
+
+	assert(srcOffset >= 0 && srcOffset + framesToCopy <= b.countFrames());
+
+	float*       dest = (*this)[destOffset];
+	const float* src  = b[srcOffset];
+
 	/* Case 1) source has less channels than this one: brutally spread source's
 	channel 0 over this one (TODO - maybe mixdown source channels first?)
-	   Case 2) source has same amount of channels: copy them 1:1. */
+	   Case 2) source has same amount of channels: copy them 1:1. Mono buffers
+	get the left pan factor only. */
+
+	const simd::Kernels& k    = simd::get();
+	const float          panR = destChannels == 1 ? pan[0] : pan[1];
 
-	for (int destF = 0, srcF = srcOffset; destF < framesToCopy && destF < b.countFrames(); destF++, srcF++)
+	if (sameChannels)
 	{
-		for (int ch = 0; ch < destChannels; ch++)
-		{
-			if constexpr (O == Operation::SUM)
-				sum(destF + destOffset, ch, b[srcF][sameChannels ? ch : 0] * gain * pan[ch]);
-			else
-				set(destF + destOffset, ch, b[srcF][sameChannels ? ch : 0] * gain * pan[ch]);
-		}
+		if constexpr (O == Operation::SUM)
+			k.sum(dest, src, framesToCopy * destChannels, gain, pan[0], panR);
+		else
+			k.set(dest, src, framesToCopy * destChannels, gain, pan[0], panR);
+	}
+	else
+	{
+		if constexpr (O == Operation::SUM)
+			k.sumMonoToStereo(dest, src, framesToCopy, gain, pan[0], panR);
+		else
+			k.setMonoToStereo(dest, src, framesToCopy, gain, pan[0], panR);
 	}
 }
 
@@ -226,14 +259,65 @@ void AudioBuffer::copyData(const AudioBuffer& b, Frame framesToCopy,
 
 void AudioBuffer::applyGain(float g)
 {
-	for (int i = 0; i < countSamples(); i++)
-		m_data[i] *= g;
+	if (m_data == nullptr)
+		return;
+	simd::get().applyGain(m_data, countSamples(), g);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void AudioBuffer::applyRamp(Frame offset, Frame count, float gain, float step)
+{
+	if (m_data == nullptr)
+		return;
+
+	assert(offset >= 0 && offset + count <= m_size);
+
+	simd::get().applyRamp(m_data + (offset * m_channels), count * m_channels,
+	    m_channels, gain, step);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void AudioBuffer::sum(Frame f, int channel, float val) { (*this)[f][channel] += val; }
-void AudioBuffer::set(Frame f, int channel, float val) { (*this)[f][channel] = val; }
+void AudioBuffer::toPlanar(float* const* dest) const
+{
+	assert(m_data != nullptr);
+
+	for (int ch = 0; ch < m_channels; ch++)
+	{
+		const float* src = m_data + ch;
+		float*       out = dest[ch];
+		for (Frame f = 0; f < m_size; f++)
+			out[f] = src[f * m_channels];
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void AudioBuffer::fromPlanar(const float* const* src)
+{
+	assert(m_data != nullptr);
+
+	for (int ch = 0; ch < m_channels; ch++)
+	{
+		const float* in  = src[ch];
+		float*       out = m_data + ch;
+		for (Frame f = 0; f < m_size; f++)
+			out[f * m_channels] = in[f];
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+float* AudioBuffer::allocData(int samples)
+{
+	return new (std::align_val_t{ALIGNMENT}) float[samples];
+}
+
+void AudioBuffer::freeData(float* data)
+{
+	::operator delete[](data, std::align_val_t{ALIGNMENT});
+}
 
 /* -------------------------------------------------------------------------- */
 
@@ -241,6 +325,8 @@ void AudioBuffer::move(AudioBuffer&& o)
 {
 	assert(o.countChannels() <= NUM_CHANS);
 
+	free();
+
 	m_data     = o.m_data;
 	m_size     = o.m_size;
 	m_channels = o.m_channels;
@@ -256,10 +342,14 @@ void AudioBuffer::move(AudioBuffer&& o)
 
 void AudioBuffer::copy(const AudioBuffer& o)
 {
-	m_data     = new float[o.m_size * o.m_channels];
+	/* A copy always owns its data, even if 'o' is just viewing someone 
+	else's. */
+
+	free();
+	m_data     = allocData(o.m_size * o.m_channels);
 	m_size     = o.m_size;
 	m_channels = o.m_channels;
-	m_viewing  = o.m_viewing;
+	m_viewing  = false;
 
 	std::copy(o.m_data, o.m_data + (o.m_size * o.m_channels), m_data);
 }
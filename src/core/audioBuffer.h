@@ -29,6 +29,7 @@
 
 #include "core/types.h"
 #include <array>
+#include <cstddef>
 
 namespace giada::m
 {
@@ -42,6 +43,12 @@ class AudioBuffer
 public:
 	static constexpr int NUM_CHANS = 2;
 
+	/* ALIGNMENT
+	Memory alignment, in bytes, of the allocated data. Large enough for any 
+	SIMD register and a cache line. */
+
+	static constexpr std::size_t ALIGNMENT = 64;
+
 	using Pan = std::array<float, NUM_CHANS>;
 
 	/* AudioBuffer (1)
@@ -108,6 +115,11 @@ public:
 
 	float getPeak() const;
 
+	/* getMagnitude
+	Returns the highest absolute value from any channel. */
+
+	float getMagnitude() const;
+
 	void alloc(Frame size, int channels);
 	void free();
 
@@ -137,6 +149,20 @@ public:
 
 	void applyGain(float g);
 
+	/* applyRamp
+	Multiplies 'count' frames starting from frame 'offset' by a linear gain 
+	ramp: 'gain' on the first frame, changing by 'step' on each frame. */
+
+	void applyRamp(Frame offset, Frame count, float gain, float step);
+
+	/* toPlanar, fromPlanar
+	Copies the whole buffer to (or from) 'countChannels()' separate arrays, one 
+	per channel, of at least 'countFrames()' floats each. Useful to talk to 
+	APIs that work with planar data, such as JUCE. */
+
+	void toPlanar(float* const* dest) const;
+	void fromPlanar(const float* const* src);
+
 private:
 	enum class Operation
 	{
@@ -149,10 +175,14 @@ private:
 	    Frame srcOffset = 0, Frame destOffset = 0, float gain = 1.0f,
 	    Pan pan = {1.0f, 1.0f});
 
+	/* allocData, freeData
+	Allocate and free aligned memory for 'samples' floats. */
+
+	static float* allocData(int samples);
+	static void   freeData(float* data);
+
 	void move(AudioBuffer&& o);
 	void copy(const AudioBuffer& o);
-	void sum(Frame f, int channel, float val);
-	void set(Frame f, int channel, float val);
 
 	float* m_data;
 	Frame  m_size;
@@ -0,0 +1,133 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/blockClock.h"
+#include "core/const.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace giada::m
+{
+namespace
+{
+constexpr int64_t NS_PER_SECOND = 1000000000;
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+BlockClock::BlockClock()
+: m_start(0)
+, m_length(0)
+, m_frames(0)
+, m_position(0)
+, m_sampleRate(G_DEFAULT_SAMPLERATE)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+void BlockClock::reset(int sampleRate)
+{
+	assert(sampleRate > 0);
+
+	m_sampleRate.store(sampleRate);
+	m_start.store(0);
+	m_length.store(0);
+	m_frames.store(0);
+	m_position.store(0);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void BlockClock::tick(Time now, Frame frames, Frame position)
+{
+	const int64_t measured = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+	const int64_t start    = m_start.load();
+	const int64_t length   = m_length.load();
+
+	/* The expected start is the previous one plus the length of the previous
+	block. Move towards the measured time only by a fraction of the error, to 
+	filter out the scheduling jitter. Jump straight to the measured time if the
+	error is larger than a whole block: first block ever, or the stream has 
+	been interrupted (e.g. xrun). */
+
+	const int64_t expected = start + length;
+	const int64_t error    = measured - expected;
+
+	if (start == 0 || std::abs(error) > length)
+		m_start.store(measured);
+	else
+		m_start.store(expected + static_cast<int64_t>(error * G_BLOCK_CLOCK_SMOOTHING));
+
+	m_length.store((frames * NS_PER_SECOND) / m_sampleRate.load());
+	m_frames.store(frames);
+	m_position.store(position);
+}
+
+/* -------------------------------------------------------------------------- */
+
+Frame BlockClock::getOffset(Time t) const
+{
+	const Frame frames = m_frames.load();
+	if (frames == 0)
+		return 0;
+
+	/* Clamp the elapsed time to a sane range first, so that very old (or 
+	unset) timestamps can't overflow the conversion below. */
+
+	const int64_t time    = std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+	const int64_t elapsed = std::clamp<int64_t>(time - m_start.load(), 0, NS_PER_SECOND);
+	const Frame   offset  = static_cast<Frame>((elapsed * m_sampleRate.load()) / NS_PER_SECOND);
+
+	return std::clamp(offset, 0, frames - 1);
+}
+
+/* -------------------------------------------------------------------------- */
+
+Frame BlockClock::getPosition(Time t) const
+{
+	/* Not clamped to the block like getOffset(): events are often handled a 
+	block or two after they were received, which must not snap them to a block
+	start. Only very old (or unset) timestamps are limited, to prevent overflow
+	in the conversion below. */
+
+	const int64_t time    = std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+	const int64_t elapsed = std::clamp<int64_t>(time - m_start.load(), -NS_PER_SECOND, NS_PER_SECOND);
+
+	return m_position.load() + static_cast<Frame>((elapsed * m_sampleRate.load()) / NS_PER_SECOND);
+}
+
+/* -------------------------------------------------------------------------- */
+
+BlockClock::Time BlockClock::getTime(Frame offset) const
+{
+	const int64_t elapsed = (static_cast<int64_t>(offset) * NS_PER_SECOND) / m_sampleRate.load();
+	return Time(std::chrono::duration_cast<Time::duration>(std::chrono::nanoseconds(m_start.load() + elapsed)));
+}
+} // namespace giada::m
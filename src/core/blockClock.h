@@ -0,0 +1,98 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_BLOCK_CLOCK_H
+#define G_BLOCK_CLOCK_H
+
+#include "core/types.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace giada::m
+{
+/* BlockClock
+Correlates the system clock with the audio stream. The realtime thread marks
+the beginning of each block with tick(); the start times are smoothed over, 
+as audio callbacks are scheduled with some jitter. Any thread can then convert
+a timestamp into a frame offset: an event received during the current block is
+placed at the same relative position in the next one, i.e. with a constant
+latency of one block and no jitter. */
+
+class BlockClock
+{
+public:
+	using Time = std::chrono::steady_clock::time_point;
+
+	BlockClock();
+
+	/* reset
+	Sets the sample rate in use and forgets the previous block times. Call it 
+	when the audio stream (re)starts. */
+
+	void reset(int sampleRate);
+
+	/* tick
+	Marks the beginning of a new block of 'frames' frames, happened at time 
+	'now'. 'position' is the sequencer frame the block starts from, if any. 
+	Realtime thread only. */
+
+	void tick(Time now, Frame frames, Frame position = 0);
+
+	/* getOffset
+	Returns the frame offset, within the next block, of an event received at 
+	time 't'. Always in [0, frames - 1], where 'frames' is the size of the last 
+	block. */
+
+	Frame getOffset(Time t) const;
+
+	/* getPosition
+	Returns the sequencer frame being rendered at time 't', i.e. the position of
+	the current block plus the time elapsed since its start, which may be 
+	negative if 't' precedes it. Unlike the block position alone, it doesn't 
+	depend on the buffer size nor on when the event is handled. Not wrapped 
+	around the loop length. */
+
+	Frame getPosition(Time t) const;
+
+	/* getTime
+	Returns the time of frame 'offset' of the current block, i.e. the last one
+	marked with tick(). */
+
+	Time getTime(Frame offset) const;
+
+private:
+	/* Block start time and length in nanoseconds, read by other threads. */
+
+	std::atomic<int64_t> m_start;
+	std::atomic<int64_t> m_length;
+	std::atomic<Frame>   m_frames;
+	std::atomic<Frame>   m_position;
+	std::atomic<int>     m_sampleRate;
+};
+} // namespace giada::m
+
+#endif
@@ -45,6 +45,9 @@ void render(const channel::Data& ch, const AudioBuffer& in)
 	(i.e. not plugin-processed). */
 
 	if (ch.armed && ch.audioReceiver->inputMonitor)
+	{
 		ch.buffer->audio.set(in, /*gain=*/1.0f); // add, don't overwrite
+		ch.buffer->silent = false;
+	}
 }
 } // namespace giada::m::audioReceiver
\ No newline at end of file
@@ -25,9 +25,12 @@
  * -------------------------------------------------------------------------- */
 
 #include "channel.h"
+#include "core/clock.h"
 #include "core/mixerHandler.h"
 #include "core/plugins/pluginHost.h"
 #include "core/plugins/pluginManager.h"
+#include "core/recorder.h"
+#include <algorithm>
 #include <cassert>
 
 namespace giada::m::channel
@@ -50,19 +53,28 @@ AudioBuffer::Pan calcPanning_(float pan)
 
 void react_(Data& d, const eventDispatcher::Event& e)
 {
+	/* If the event has already been applied by the audio thread, State is up 
+	to date: just update Data. */
+
 	switch (e.type)
 	{
 
 	case eventDispatcher::EventType::CHANNEL_VOLUME:
 		d.volume = std::get<float>(e.data);
+		if (!e.rt)
+			d.state->volume.store(d.volume);
 		break;
 
 	case eventDispatcher::EventType::CHANNEL_PAN:
 		d.pan = std::get<float>(e.data);
+		if (!e.rt)
+			d.state->pan.store(d.pan);
 		break;
 
 	case eventDispatcher::EventType::CHANNEL_MUTE:
 		d.mute = !d.mute;
+		if (!e.rt)
+			d.state->mute.store(d.mute);
 		break;
 
 	case eventDispatcher::EventType::CHANNEL_TOGGLE_ARM:
@@ -83,12 +95,20 @@ void react_(Data& d, const eventDispatcher::Event& e)
 
 void renderMasterOut_(const Data& d, AudioBuffer& out)
 {
-	d.buffer->audio.set(out, /*gain=*/1.0f);
+	/* Without plug-ins there's nothing to process: skip the round trip through
+	the channel buffer and apply volume in place. */
+
 #ifdef WITH_VST
 	if (d.plugins.size() > 0)
-		pluginHost::processStack(d.buffer->audio, d.plugins, nullptr);
+	{
+		d.buffer->audio.set(out, /*gain=*/1.0f);
+		pluginHost::processStack(d.buffer->audio, d.plugins, d.buffer->pluginAudio,
+		    d.buffer->midi);
+		out.set(d.buffer->audio, d.state->volume.load());
+		return;
+	}
 #endif
-	out.set(d.buffer->audio, d.volume);
+	out.applyGain(d.state->volume.load());
 }
 
 /* -------------------------------------------------------------------------- */
@@ -97,34 +117,163 @@ void renderMasterIn_(const Data& d, AudioBuffer& in)
 {
 #ifdef WITH_VST
 	if (d.plugins.size() > 0)
-		pluginHost::processStack(in, d.plugins, nullptr);
+		pluginHost::processStack(in, d.plugins, d.buffer->pluginAudio, d.buffer->midi);
 #endif
 }
 
 /* -------------------------------------------------------------------------- */
 
-void renderChannel_(const Data& d, AudioBuffer& out, AudioBuffer& in, bool audible)
+#ifdef WITH_VST
+
+void renderPlugins_(const Data& d, Frame sleepFrames)
 {
-	d.buffer->audio.clear();
+	Buffer& buffer = *d.buffer;
 
-	if (d.samplePlayer)
-		samplePlayer::render(d);
-	if (d.audioReceiver)
-		audioReceiver::render(d, in);
+	if (d.plugins.size() == 0)
+	{
+		buffer.midi.clear();
+		return;
+	}
 
-		/* If MidiReceiver exists, let it process the plug-in stack, as it can 
+	const bool hasInput = !buffer.silent || !buffer.midi.isEmpty();
+
+	if (buffer.pluginsAsleep && !hasInput)
+		return;
+
+	/* If MidiReceiver exists, let it process the plug-in stack, as it can 
 	contain plug-ins that take MIDI events (i.e. synths). Otherwise process the
 	plug-in stack internally with no MIDI events. */
 
-#ifdef WITH_VST
 	if (d.midiReceiver)
 		midiReceiver::render(d);
-	else if (d.plugins.size() > 0)
-		pluginHost::processStack(d.buffer->audio, d.plugins, nullptr);
+	else
+		pluginHost::processStack(buffer.audio, d.plugins, buffer.pluginAudio, buffer.midi);
+
+	/* Keep track of how long the output has been quiet, the tail of a reverb
+	or a delay included. */
+
+	const float magnitude = buffer.audio.getMagnitude();
+
+	if (hasInput || magnitude >= G_PLUGIN_SLEEP_LEVEL)
+		buffer.pluginsQuietFrames = 0;
+	else
+		buffer.pluginsQuietFrames += buffer.audio.countFrames();
+
+	buffer.pluginsAsleep = sleepFrames > 0 && buffer.pluginsQuietFrames >= sleepFrames;
+	buffer.silent        = magnitude == 0.0f;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+/* renderEnvelope_
+Applies the recorded volume envelope, if any, to the block starting from frame 
+'frame' of the sequencer. Each linear piece of the envelope becomes a gain ramp
+over the corresponding frames. */
+
+void renderEnvelope_(const Data& d, Frame frame)
+{
+	Buffer& buffer = *d.buffer;
+
+	if (frame < 0 || buffer.silent || !d.readActions)
+		return;
+
+	const recorder::Timeline& timeline = recorder::getTimeline();
+	const auto                it       = timeline.envelopes.find(d.id);
+	if (it == timeline.envelopes.end())
+		return;
+
+	it->second.forEachSegment(frame, buffer.audio.countFrames(), clock::getFramesInLoop(),
+	    [&buffer](const Envelope::Segment& s) {
+		    buffer.audio.applyRamp(s.offset, s.count, s.gain, s.step);
+	    });
+}
+
+/* -------------------------------------------------------------------------- */
+
+void renderChannel_(const Data& d, AudioBuffer& in, Frame pluginSleepFrames, Frame frame)
+{
+	/* Components that render something into the buffer mark it as non-silent.
+	A silent buffer is already clean, no need to clear it again. */
+
+	if (!d.buffer->silent)
+		d.buffer->audio.clear();
+	d.buffer->silent = true;
+
+	if (d.samplePlayer)
+		samplePlayer::render(d);
+	if (d.audioReceiver)
+		audioReceiver::render(d, in);
+
+#ifdef WITH_VST
+	renderPlugins_(d, pluginSleepFrames);
+#else
+	(void)pluginSleepFrames;
 #endif
 
-	if (audible)
-		out.sum(d.buffer->audio, d.volume * d.volume_i, calcPanning_(d.pan));
+	renderEnvelope_(d, frame);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void sumChannel_(const Data& d, AudioBuffer& out, bool audible)
+{
+	Buffer& buffer = *d.buffer;
+
+	if (audible && !buffer.silent)
+	{
+		const float volume_i = d.state->volume_i.load();
+
+		if (buffer.numParamChanges == 0)
+		{
+			if (!d.state->mute.load())
+				out.sum(buffer.audio, d.state->volume.load() * volume_i, calcPanning_(d.state->pan.load()));
+		}
+		else
+		{
+			/* Parameters have changed within this block: sum it in slices, each
+			one with its own volume, panning and mute. */
+
+			for (std::size_t i = 0; i < buffer.numParamChanges; i++)
+			{
+				const Buffer::ParamChange& c     = buffer.paramChanges[i];
+				const Frame                end   = i + 1 < buffer.numParamChanges ? buffer.paramChanges[i + 1].offset : buffer.audio.countFrames();
+				const Frame                count = end - c.offset;
+				if (c.mute || count <= 0)
+					continue;
+				out.sum(buffer.audio, count, c.offset, c.offset, c.volume * volume_i, calcPanning_(c.pan));
+			}
+		}
+	}
+
+	buffer.numParamChanges = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* pushParamChange_
+Records the current volume, panning and mute of channel 'd' as a change taking 
+place at frame 'offset' in the current block. The first change of a block also
+records the values the block started with, passed in 'prev'. */
+
+void pushParamChange_(const Data& d, Frame offset, Buffer::ParamChange prev)
+{
+	Buffer& buffer = *d.buffer;
+
+	if (buffer.numParamChanges == 0)
+		buffer.paramChanges[buffer.numParamChanges++] = prev;
+
+	/* Changes must be sorted and within the block: a late event can't go back
+	in time. When there's no room left, the last change gets overwritten. */
+
+	offset = std::clamp(offset, buffer.paramChanges[buffer.numParamChanges - 1].offset,
+	    buffer.audio.countFrames());
+	if (buffer.numParamChanges == buffer.paramChanges.size())
+		buffer.numParamChanges--;
+
+	buffer.paramChanges[buffer.numParamChanges++] = {offset, d.state->volume.load(),
+	    d.state->pan.load(), d.state->mute.load()};
 }
 } // namespace
 
@@ -134,7 +283,17 @@ void renderChannel_(const Data& d, AudioBuffer& out, AudioBuffer& in, bool audib
 
 Buffer::Buffer(Frame bufferSize)
 : audio(bufferSize, G_MAX_IO_CHANS)
+, silent(true)
+, numParamChanges(0)
+#ifdef WITH_VST
+, pluginAudio(G_MAX_IO_CHANS, bufferSize)
+, pluginsAsleep(false)
+, pluginsQuietFrames(0)
+#endif
 {
+#ifdef WITH_VST
+	midi.ensureSize(G_DEFAULT_VST_MIDIBUFFER_SIZE);
+#endif
 }
 
 /* -------------------------------------------------------------------------- */
@@ -146,7 +305,6 @@ Data::Data(ChannelType type, ID id, ID columnId, State& state, Buffer& buffer)
 , type(type)
 , columnId(columnId)
 , volume(G_DEFAULT_VOL)
-, volume_i(G_DEFAULT_VOL)
 , pan(G_DEFAULT_PAN)
 , mute(false)
 , solo(false)
@@ -160,14 +318,14 @@ Data::Data(ChannelType type, ID id, ID columnId, State& state, Buffer& buffer)
 	{
 
 	case ChannelType::SAMPLE:
-		samplePlayer.emplace();
+		samplePlayer.emplace(id);
 		sampleReactor.emplace(id);
 		audioReceiver.emplace();
 		sampleActionRecorder.emplace();
 		break;
 
 	case ChannelType::PREVIEW:
-		samplePlayer.emplace();
+		samplePlayer.emplace(id);
 		sampleReactor.emplace(id);
 		break;
 
@@ -183,6 +341,8 @@ Data::Data(ChannelType type, ID id, ID columnId, State& state, Buffer& buffer)
 	default:
 		break;
 	}
+
+	syncState(*this);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -194,7 +354,6 @@ Data::Data(const patch::Channel& p, State& state, Buffer& buffer, float samplera
 , type(p.type)
 , columnId(p.columnId)
 , volume(p.volume)
-, volume_i(G_DEFAULT_VOL)
 , pan(p.pan)
 , mute(p.mute)
 , solo(p.solo)
@@ -236,6 +395,8 @@ Data::Data(const patch::Channel& p, State& state, Buffer& buffer, float samplera
 	default:
 		break;
 	}
+
+	syncState(*this);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -308,38 +469,74 @@ void advance(const Data& d, const sequencer::EventBuffer& events)
 
 /* -------------------------------------------------------------------------- */
 
-void react(Data& d, const eventDispatcher::EventBuffer& events, bool audible)
+void react(Data& d, const eventDispatcher::Event& e, bool audible)
 {
-	for (const eventDispatcher::Event& e : events)
-	{
-
-		if (e.channelId > 0 && e.channelId != d.id)
-			continue;
+	assert(e.channelId == 0 || e.channelId == d.id);
 
-		react_(d, e);
-		midiLighter::react(d, e, audible);
+	react_(d, e);
+	midiLighter::react(d, e, audible);
 
-		if (d.midiController)
-			midiController::react(d, e);
+	if (d.midiController)
+		midiController::react(d, e);
 #ifdef WITH_VST
-		if (d.midiReceiver)
-			midiReceiver::react(d, e);
+	if (d.midiReceiver)
+		midiReceiver::react(d, e);
 #endif
-		if (d.midiSender)
-			midiSender::react(d, e);
-		if (d.samplePlayer)
-			samplePlayer::react(d, e);
-		if (d.midiActionRecorder)
-			midiActionRecorder::react(d, e);
-		if (d.sampleActionRecorder)
-			sampleActionRecorder::react(d, e);
+	if (d.midiSender)
+		midiSender::react(d, e);
+	if (d.samplePlayer)
+		samplePlayer::react(d, e);
+	if (d.midiActionRecorder)
+		midiActionRecorder::react(d, e);
+	if (d.sampleActionRecorder)
+		sampleActionRecorder::react(d, e);
+	if (d.sampleReactor)
+		sampleReactor::react(d, e);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void reactRt(const Data& d, const eventDispatcher::Event& e)
+{
+	const Buffer::ParamChange prev = {0, d.state->volume.load(), d.state->pan.load(),
+	    d.state->mute.load()};
+
+	switch (e.type)
+	{
+
+	case eventDispatcher::EventType::CHANNEL_VOLUME:
+		d.state->volume.store(std::get<float>(e.data));
+		pushParamChange_(d, e.delta, prev);
+		break;
+
+	case eventDispatcher::EventType::CHANNEL_PAN:
+		d.state->pan.store(std::get<float>(e.data));
+		pushParamChange_(d, e.delta, prev);
+		break;
+
+	case eventDispatcher::EventType::CHANNEL_MUTE:
+		d.state->mute.store(!prev.mute);
+		pushParamChange_(d, e.delta, prev);
+		break;
+
+	default:
 		if (d.sampleReactor)
-			sampleReactor::react(d, e);
+			sampleReactor::reactRt(d, e);
+		break;
 	}
 }
 
 /* -------------------------------------------------------------------------- */
 
+void syncState(const Data& d)
+{
+	d.state->volume.store(d.volume);
+	d.state->pan.store(d.pan);
+	d.state->mute.store(d.mute);
+}
+
+/* -------------------------------------------------------------------------- */
+
 void render(const Data& d, AudioBuffer* out, AudioBuffer* in, bool audible)
 {
 	if (d.id == mixer::MASTER_OUT_CHANNEL_ID)
@@ -347,6 +544,25 @@ void render(const Data& d, AudioBuffer* out, AudioBuffer* in, bool audible)
 	else if (d.id == mixer::MASTER_IN_CHANNEL_ID)
 		renderMasterIn_(d, *in);
 	else
-		renderChannel_(d, *out, *in, audible);
+	{
+		renderChannel_(d, *in, /*pluginSleepFrames=*/0, /*frame=*/-1);
+		sumChannel_(d, *out, audible);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void renderBuffer(const Data& d, AudioBuffer& in, Frame pluginSleepFrames, Frame frame)
+{
+	assert(!d.isInternal());
+	renderChannel_(d, in, pluginSleepFrames, frame);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void sumBuffer(const Data& d, AudioBuffer& out, bool audible)
+{
+	assert(!d.isInternal());
+	sumChannel_(d, out, audible);
 }
 } // namespace giada::m::channel
\ No newline at end of file
@@ -27,6 +27,7 @@
 #ifndef G_CHANNEL_H
 #define G_CHANNEL_H
 
+#include <array>
 #include <optional>
 #ifdef WITH_VST
 #include "deps/juce-config.h"
@@ -61,15 +62,69 @@ struct State
 	WeakAtomic<ChannelStatus> recStatus  = ChannelStatus::OFF;
 	bool                      rewinding;
 	Frame                     offset;
+
+	/* stopOffset
+	If > 0, the player stops at this frame within the current block. */
+
+	Frame stopOffset = 0;
+
+	/* volume, volume_i, pan, mute
+	Values the audio thread renders with. They mirror the ones in Data (volume_i
+	excluded, it's internal), but can be changed without a layout swap. */
+
+	WeakAtomic<float> volume   = G_DEFAULT_VOL;
+	WeakAtomic<float> volume_i = G_DEFAULT_VOL; // Velocity-drives-volume mode on Sample Channels
+	WeakAtomic<float> pan      = G_DEFAULT_PAN;
+	WeakAtomic<bool>  mute     = false;
 };
 
 struct Buffer
 {
+	/* ParamChange
+	Volume, panning or mute change applied by the audio thread at frame 
+	'offset' within the current block. */
+
+	struct ParamChange
+	{
+		Frame offset;
+		float volume;
+		float pan;
+		bool  mute;
+	};
+
 	Buffer(Frame bufferSize);
 
 	AudioBuffer audio;
+
+	/* silent
+	True if 'audio' contains only zeros. Idle channels are neither cleared nor
+	summed to the output. */
+
+	bool silent;
+
+	/* paramChanges, numParamChanges
+	Parameter changes for the current block, sorted by offset. The first one, 
+	at offset 0, holds the values the block started with. The buffer is summed 
+	to the output in slices, one per change. Empty if nothing has changed. */
+
+	std::array<ParamChange, G_MAX_PARAM_CHANGES> paramChanges;
+	std::size_t                                  numParamChanges;
+
 #ifdef WITH_VST
 	juce::MidiBuffer midi;
+
+	/* pluginAudio
+	Scratch buffer for the plug-in stack, in JUCE format. */
+
+	juce::AudioBuffer<float> pluginAudio;
+
+	/* pluginsAsleep, pluginsQuietFrames
+	The plug-in stack goes to sleep when its output has stayed below 
+	G_PLUGIN_SLEEP_LEVEL, with no input, for a while. It wakes up on the next 
+	non-silent input or MIDI event. */
+
+	bool  pluginsAsleep;
+	Frame pluginsQuietFrames;
 #endif
 };
 
@@ -97,7 +152,6 @@ struct Data
 	ChannelType type;
 	ID          columnId;
 	float       volume;
-	float       volume_i; // Internal volume used for velocity-drives-volume mode on Sample Channels
 	float       pan;
 	bool        mute;
 	bool        solo;
@@ -133,15 +187,45 @@ actions or sequencer events) in the current block. */
 void advance(const Data& d, const sequencer::EventBuffer& e);
 
 /* react
-Reacts to live events coming from the EventDispatcher (human events) and
-updates itself accordingly. */
+Reacts to a live event coming from the EventDispatcher (human events) and
+updates itself accordingly. The event must be directed to this channel, or to
+all channels. */
+
+void react(Data& d, const eventDispatcher::Event& e, bool audible);
+
+/* reactRt
+[realtime] Reacts to a live event forwarded to the audio thread, at frame 
+'e.delta' within the current block. Only play/stop, volume, pan and mute: it 
+just touches State, so no layout swap is needed. */
+
+void reactRt(const Data& d, const eventDispatcher::Event& e);
 
-void react(Data& d, const eventDispatcher::EventBuffer& e, bool audible);
+/* syncState
+Copies volume, pan and mute from Data to its State. */
+
+void syncState(const Data& d);
 
 /* render
 Renders audio data to I/O buffers. */
 
 void render(const Data& d, AudioBuffer* out, AudioBuffer* in, bool audible);
+
+/* renderBuffer
+Renders a regular (non-internal) channel into its own Buffer, without touching
+the output. Channels don't share any data while rendering, so this can be 
+called concurrently on different channels. The plug-in stack is put to sleep
+after 'pluginSleepFrames' of silence (0 = never). 'frame' is the sequencer 
+frame the block starts from, used to render recorded envelopes, or -1 if the 
+sequencer is not running. */
+
+void renderBuffer(const Data& d, AudioBuffer& in, Frame pluginSleepFrames, Frame frame);
+
+/* sumBuffer
+Sums the Buffer previously rendered by renderBuffer() into 'out', applying 
+volume, panning and mute. 'audible' is false if the channel is silenced by 
+other soloed channels. Silent Buffers are skipped. */
+
+void sumBuffer(const Data& d, AudioBuffer& out, bool audible);
 } // namespace giada::m::channel
 
 #endif
@@ -94,6 +94,13 @@ channel::Data create(const channel::Data& o)
 	out.state  = &makeState_();
 	out.buffer = &makeBuffer_();
 
+	channel::syncState(out);
+
+	/* The clone needs its own resampler: don't share the original one. */
+
+	if (out.samplePlayer)
+		out.samplePlayer->waveReader = WaveReader(out.id, out.samplePlayer->getWave());
+
 	return out;
 }
 
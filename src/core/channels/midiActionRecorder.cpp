@@ -34,16 +34,17 @@
 #include "core/recManager.h"
 #include "core/recorderHandler.h"
 #include <cassert>
+#include <chrono>
 
 namespace giada::m::midiActionRecorder
 {
 namespace
 {
-void record_(channel::Data& ch, const MidiEvent& e)
+void record_(channel::Data& ch, const MidiEvent& e, std::chrono::steady_clock::time_point t)
 {
 	MidiEvent flat(e);
 	flat.setChannel(0);
-	recorderHandler::liveRec(ch.id, flat, clock::quantize(clock::getCurrentFrame()));
+	recorderHandler::liveRec(ch.id, flat, clock::quantize(clock::getFrameAt(t)));
 	ch.hasActions = true;
 }
 
@@ -64,6 +65,6 @@ bool canRecord_()
 void react(channel::Data& ch, const eventDispatcher::Event& e)
 {
 	if (e.type == eventDispatcher::EventType::MIDI && canRecord_())
-		record_(ch, std::get<Action>(e.data).event);
+		record_(ch, std::get<Action>(e.data).event, e.pushTime);
 }
 } // namespace giada::m::midiActionRecorder
\ No newline at end of file
@@ -47,15 +47,16 @@ void sendToPlugins_(const channel::Data& ch, const MidiEvent& e, Frame localFram
 
 /* -------------------------------------------------------------------------- */
 
-void parseMidi_(const channel::Data& ch, const MidiEvent& e)
+void parseMidi_(const channel::Data& ch, const eventDispatcher::Event& e)
 {
 	/* Now all messages are turned into Channel-0 messages. Giada doesn't care 
 	about holding MIDI channel information. Moreover, having all internal 
-	messages on channel 0 is way easier. Then send it to plug-ins. */
+	messages on channel 0 is way easier. Then send it to plug-ins, at the frame
+	in the next block that matches the time the message has been received. */
 
-	MidiEvent flat(e);
+	MidiEvent flat(std::get<Action>(e.data).event);
 	flat.setChannel(0);
-	sendToPlugins_(ch, flat, /*delta=*/0);
+	sendToPlugins_(ch, flat, mixer::getBlockOffset(e.pushTime));
 }
 } // namespace
 
@@ -69,7 +70,7 @@ void react(const channel::Data& ch, const eventDispatcher::Event& e)
 	{
 
 	case eventDispatcher::EventType::MIDI:
-		parseMidi_(ch, std::get<Action>(e.data).event);
+		parseMidi_(ch, e);
 		break;
 
 	case eventDispatcher::EventType::KEY_KILL:
@@ -88,7 +89,7 @@ void react(const channel::Data& ch, const eventDispatcher::Event& e)
 void advance(const channel::Data& ch, const sequencer::Event& e)
 {
 	if (e.type == sequencer::EventType::ACTIONS && ch.isPlaying())
-		for (const Action& action : *e.actions)
+		for (const Action& action : e.actions)
 			if (action.channelId == ch.id)
 				sendToPlugins_(ch, action.event, e.delta);
 }
@@ -97,8 +98,8 @@ void advance(const channel::Data& ch, const sequencer::Event& e)
 
 void render(const channel::Data& ch)
 {
-	pluginHost::processStack(ch.buffer->audio, ch.plugins, &ch.buffer->midi);
-	ch.buffer->midi.clear();
+	pluginHost::processStack(ch.buffer->audio, ch.plugins, ch.buffer->pluginAudio,
+	    ch.buffer->midi, /*isMidiStack=*/true);
 }
 } // namespace giada::m::midiReceiver
 
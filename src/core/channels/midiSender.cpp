@@ -41,11 +41,23 @@ void send_(const channel::Data& ch, MidiEvent e)
 
 /* -------------------------------------------------------------------------- */
 
-void parseActions_(const channel::Data& ch, const std::vector<Action>& as)
+/* sendAt_
+Sends event 'e' along with frame 'localFrame' of the current block. Realtime 
+thread only. */
+
+void sendAt_(const channel::Data& ch, MidiEvent e, Frame localFrame)
+{
+	e.setChannel(ch.midiSender->filter);
+	kernelMidi::sendAt(e.getRaw(), localFrame);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void parseActions_(const channel::Data& ch, ActionTable::View as, Frame localFrame)
 {
 	for (const Action& a : as)
 		if (a.channelId == ch.id)
-			send_(ch, a.event);
+			sendAt_(ch, a.event, localFrame);
 }
 } // namespace
 
@@ -78,6 +90,6 @@ void advance(const channel::Data& ch, const sequencer::Event& e)
 	if (!ch.midiSender->enabled)
 		return;
 	if (e.type == sequencer::EventType::ACTIONS)
-		parseActions_(ch, *e.actions);
+		parseActions_(ch, e.actions, e.delta);
 }
 } // namespace giada::m::midiSender
@@ -34,13 +34,14 @@
 #include "core/recManager.h"
 #include "core/recorderHandler.h"
 #include <cassert>
+#include <chrono>
 
 namespace giada::m::sampleActionRecorder
 {
 namespace
 {
-void record_(channel::Data& ch, int note);
-void onKeyPress_(channel::Data& ch);
+void record_(channel::Data& ch, int note, std::chrono::steady_clock::time_point t);
+void onKeyPress_(channel::Data& ch, std::chrono::steady_clock::time_point t);
 void toggleReadActions_(channel::Data& ch);
 void startReadActions_(channel::Data& ch);
 void stopReadActions_(channel::Data& ch, ChannelStatus curRecStatus);
@@ -59,11 +60,11 @@ bool canRecord_(const channel::Data& ch)
 
 /* -------------------------------------------------------------------------- */
 
-void onKeyPress_(channel::Data& ch)
+void onKeyPress_(channel::Data& ch, std::chrono::steady_clock::time_point t)
 {
 	if (!canRecord_(ch))
 		return;
-	record_(ch, MidiEvent::NOTE_ON);
+	record_(ch, MidiEvent::NOTE_ON, t);
 
 	/* Skip reading actions when recording on ChannelMode::SINGLE_PRESS to 
 	prevent	existing actions to interfere with the keypress/keyrel combo. */
@@ -74,10 +75,10 @@ void onKeyPress_(channel::Data& ch)
 
 /* -------------------------------------------------------------------------- */
 
-void record_(channel::Data& ch, int note)
+void record_(channel::Data& ch, int note, std::chrono::steady_clock::time_point t)
 {
 	recorderHandler::liveRec(ch.id, MidiEvent(note, 0, 0),
-	    clock::quantize(clock::getCurrentFrame()));
+	    clock::quantize(clock::getFrameAt(t)));
 
 	ch.hasActions = true;
 }
@@ -167,7 +168,7 @@ void react(channel::Data& ch, const eventDispatcher::Event& e)
 	{
 
 	case eventDispatcher::EventType::KEY_PRESS:
-		onKeyPress_(ch);
+		onKeyPress_(ch, e.pushTime);
 		break;
 
 		/* Record a stop event only if channel is SINGLE_PRESS. For any other 
@@ -175,12 +176,12 @@ void react(channel::Data& ch, const eventDispatcher::Event& e)
 
 	case eventDispatcher::EventType::KEY_RELEASE:
 		if (canRecord_(ch) && ch.samplePlayer->mode == SamplePlayerMode::SINGLE_PRESS)
-			record_(ch, MidiEvent::NOTE_OFF);
+			record_(ch, MidiEvent::NOTE_OFF, e.pushTime);
 		break;
 
 	case eventDispatcher::EventType::KEY_KILL:
 		if (canRecord_(ch))
-			record_(ch, MidiEvent::NOTE_KILL);
+			record_(ch, MidiEvent::NOTE_KILL, e.pushTime);
 		break;
 
 	case eventDispatcher::EventType::CHANNEL_TOGGLE_READ_ACTIONS:
@@ -146,7 +146,7 @@ void onNoteOff_(const channel::Data& ch, Frame localFrame)
 
 /* -------------------------------------------------------------------------- */
 
-void parseActions_(const channel::Data& ch, const std::vector<Action>& as, Frame localFrame)
+void parseActions_(const channel::Data& ch, ActionTable::View as, Frame localFrame)
 {
 	if (ch.samplePlayer->isAnyLoopMode())
 		return;
@@ -230,7 +230,7 @@ void advance(const channel::Data& ch, const sequencer::Event& e)
 
 	case sequencer::EventType::ACTIONS:
 		if (ch.readActions)
-			parseActions_(ch, *e.actions, e.delta);
+			parseActions_(ch, e.actions, e.delta);
 		break;
 
 	default:
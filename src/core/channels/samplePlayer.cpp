@@ -89,10 +89,11 @@ void setWave_(samplePlayer::Data& sp, Wave* w, float samplerateRatio)
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-Data::Data()
+Data::Data(ID channelId)
 : pitch(G_DEFAULT_PITCH)
 , mode(SamplePlayerMode::SINGLE_BASIC)
 , velocityAsVol(false)
+, waveReader(channelId)
 {
 }
 
@@ -105,6 +106,7 @@ Data::Data(const patch::Channel& p, float samplerateRatio)
 , begin(p.begin)
 , end(p.end)
 , velocityAsVol(p.midiInVeloAsVol)
+, waveReader(p.id)
 {
 	setWave_(*this, waveManager::hydrateWave(p.waveId), samplerateRatio);
 }
@@ -170,6 +172,8 @@ void render(const channel::Data& ch)
 	if (!isPlaying_(ch))
 		return;
 
+	ch.buffer->silent = false;
+
 	const Frame begin = ch.samplePlayer->begin;
 	const Frame end   = ch.samplePlayer->end;
 
@@ -205,6 +209,16 @@ void render(const channel::Data& ch)
 
 	ch.state->offset = 0;
 	ch.state->tracker.store(tracker);
+
+	/* A stop is pending within this block: silence everything after it. */
+
+	if (ch.state->stopOffset > 0)
+	{
+		ch.buffer->audio.clear(ch.state->stopOffset);
+		ch.state->stopOffset = 0;
+		ch.state->playStatus.store(ChannelStatus::OFF);
+		ch.state->tracker.store(begin);
+	}
 }
 
 /* -------------------------------------------------------------------------- */
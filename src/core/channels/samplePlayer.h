@@ -45,7 +45,7 @@ namespace giada::m::samplePlayer
 {
 struct Data
 {
-	Data();
+	Data(ID channelId);
 	Data(const patch::Channel& p, float samplerateRatio);
 	Data(const Data& o) = default;
 	Data(Data&& o)      = default;
@@ -31,6 +31,7 @@
 #include "src/core/model/model.h"
 #include "utils/math.h"
 #include <cassert>
+#include <utility>
 
 namespace giada::m::sampleReactor
 {
@@ -39,18 +40,18 @@ namespace
 constexpr int Q_ACTION_PLAY   = 0;
 constexpr int Q_ACTION_REWIND = 1;
 
-void          press_(channel::Data& ch, int velocity);
-void          release_(channel::Data& ch);
-void          kill_(channel::Data& ch);
-void          onStopBySeq_(channel::Data& ch);
-void          toggleReadActions_(channel::Data& ch);
-ChannelStatus pressWhileOff_(channel::Data& ch, int velocity, bool isLoop);
-ChannelStatus pressWhilePlay_(channel::Data& ch, SamplePlayerMode mode, bool isLoop);
-void          rewind_(channel::Data& ch, Frame localFrame = 0);
+void          press_(const channel::Data& ch, int velocity, Frame localFrame);
+void          release_(const channel::Data& ch, Frame localFrame);
+void          kill_(const channel::Data& ch, Frame localFrame = 0);
+void          onStopBySeq_(const channel::Data& ch);
+void          toggleReadActions_(const channel::Data& ch);
+ChannelStatus pressWhileOff_(const channel::Data& ch, int velocity, bool isLoop, Frame localFrame);
+ChannelStatus pressWhilePlay_(const channel::Data& ch, SamplePlayerMode mode, bool isLoop, Frame localFrame);
+void          rewind_(const channel::Data& ch, Frame localFrame = 0);
 
 /* -------------------------------------------------------------------------- */
 
-void press_(channel::Data& ch, int velocity)
+void press_(const channel::Data& ch, int velocity, Frame localFrame)
 {
 	ChannelStatus    playStatus = ch.state->playStatus.load();
 	SamplePlayerMode mode       = ch.samplePlayer->mode;
@@ -59,11 +60,11 @@ void press_(channel::Data& ch, int velocity)
 	switch (playStatus)
 	{
 	case ChannelStatus::OFF:
-		playStatus = pressWhileOff_(ch, velocity, isLoop);
+		playStatus = pressWhileOff_(ch, velocity, isLoop, localFrame);
 		break;
 
 	case ChannelStatus::PLAY:
-		playStatus = pressWhilePlay_(ch, mode, isLoop);
+		playStatus = pressWhilePlay_(ch, mode, isLoop, localFrame);
 		break;
 
 	case ChannelStatus::WAIT:
@@ -83,7 +84,7 @@ void press_(channel::Data& ch, int velocity)
 
 /* -------------------------------------------------------------------------- */
 
-void release_(channel::Data& ch)
+void release_(const channel::Data& ch, Frame localFrame)
 {
 	/* Key release is meaningful only for SINGLE_PRESS modes. */
 
@@ -95,22 +96,32 @@ void release_(channel::Data& ch)
 	disable it. */
 
 	if (ch.state->playStatus.load() == ChannelStatus::PLAY)
-		kill_(ch);
+		kill_(ch, localFrame);
 	else if (sequencer::quantizer.hasBeenTriggered())
 		sequencer::quantizer.clear();
 }
 
 /* -------------------------------------------------------------------------- */
 
-void kill_(channel::Data& ch)
+/* kill_
+Stops the channel right away, or at frame 'localFrame' of the current block if 
+> 0: the player will take care of it while rendering. */
+
+void kill_(const channel::Data& ch, Frame localFrame)
 {
+	if (localFrame > 0)
+	{
+		ch.state->stopOffset = localFrame;
+		return;
+	}
+	ch.state->stopOffset = 0;
 	ch.state->playStatus.store(ChannelStatus::OFF);
 	ch.state->tracker.store(ch.samplePlayer->begin);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void onStopBySeq_(channel::Data& ch)
+void onStopBySeq_(const channel::Data& ch)
 {
 	G_DEBUG("onStopBySeq ch=" << ch.id);
 
@@ -139,33 +150,35 @@ void onStopBySeq_(channel::Data& ch)
 
 /* -------------------------------------------------------------------------- */
 
-ChannelStatus pressWhileOff_(channel::Data& ch, int velocity, bool isLoop)
+ChannelStatus pressWhileOff_(const channel::Data& ch, int velocity, bool isLoop, Frame localFrame)
 {
 	if (isLoop)
 		return ChannelStatus::WAIT;
 
 	if (ch.samplePlayer->velocityAsVol)
-		ch.volume_i = u::math::map(velocity, G_MAX_VELOCITY, G_MAX_VOLUME);
+		ch.state->volume_i.store(u::math::map(velocity, G_MAX_VELOCITY, G_MAX_VOLUME));
 
 	if (clock::canQuantize())
 	{
 		sequencer::quantizer.trigger(Q_ACTION_PLAY + ch.id);
 		return ChannelStatus::OFF;
 	}
-	else
-		return ChannelStatus::PLAY;
+
+	ch.state->offset     = localFrame;
+	ch.state->stopOffset = 0;
+	return ChannelStatus::PLAY;
 }
 
 /* -------------------------------------------------------------------------- */
 
-ChannelStatus pressWhilePlay_(channel::Data& ch, SamplePlayerMode mode, bool isLoop)
+ChannelStatus pressWhilePlay_(const channel::Data& ch, SamplePlayerMode mode, bool isLoop, Frame localFrame)
 {
 	if (mode == SamplePlayerMode::SINGLE_RETRIG)
 	{
 		if (clock::canQuantize())
 			sequencer::quantizer.trigger(Q_ACTION_REWIND + ch.id);
 		else
-			rewind_(ch);
+			rewind_(ch, localFrame);
 		return ChannelStatus::PLAY;
 	}
 
@@ -174,6 +187,12 @@ ChannelStatus pressWhilePlay_(channel::Data& ch, SamplePlayerMode mode, bool isL
 
 	if (mode == SamplePlayerMode::SINGLE_BASIC)
 	{
+		/* Stopping later in the block: keep playing until then. */
+		if (localFrame > 0)
+		{
+			kill_(ch, localFrame);
+			return ChannelStatus::PLAY;
+		}
 		rewind_(ch);
 		return ChannelStatus::OFF;
 	}
@@ -183,7 +202,7 @@ ChannelStatus pressWhilePlay_(channel::Data& ch, SamplePlayerMode mode, bool isL
 
 /* -------------------------------------------------------------------------- */
 
-void toggleReadActions_(channel::Data& ch)
+void toggleReadActions_(const channel::Data& ch)
 {
 	if (clock::isRunning() && ch.state->recStatus.load() == ChannelStatus::PLAY && !conf::conf.treatRecsAsLoops)
 		kill_(ch);
@@ -191,7 +210,7 @@ void toggleReadActions_(channel::Data& ch)
 
 /* -------------------------------------------------------------------------- */
 
-void rewind_(channel::Data& ch, Frame localFrame)
+void rewind_(const channel::Data& ch, Frame localFrame)
 {
 	if (ch.isPlaying())
 	{
@@ -209,15 +228,17 @@ void rewind_(channel::Data& ch, Frame localFrame)
 
 Data::Data(ID channelId)
 {
+	/* These run on the realtime thread: only touch the channel state, through
+	a const Layout so that no copy is triggered. */
+
 	sequencer::quantizer.schedule(Q_ACTION_PLAY + channelId, [channelId](Frame delta) {
-		channel::Data& ch = model::get().getChannel(channelId);
-		ch.state->offset  = delta;
+		const channel::Data& ch = std::as_const(model::get()).getChannel(channelId);
+		ch.state->offset        = delta;
 		ch.state->playStatus.store(ChannelStatus::PLAY);
 	});
 
 	sequencer::quantizer.schedule(Q_ACTION_REWIND + channelId, [channelId](Frame delta) {
-		channel::Data& ch = model::get().getChannel(channelId);
-		rewind_(ch, delta);
+		rewind_(std::as_const(model::get()).getChannel(channelId), delta);
 	});
 }
 
@@ -230,19 +251,25 @@ void react(channel::Data& ch, const eventDispatcher::Event& e)
 	if (!ch.hasWave())
 		return;
 
+	/* Key events already applied by the audio thread must not be applied
+	twice. See reactRt() below. */
+
 	switch (e.type)
 	{
 
 	case eventDispatcher::EventType::KEY_PRESS:
-		press_(ch, std::get<int>(e.data));
+		if (!e.rt)
+			press_(ch, std::get<int>(e.data), /*localFrame=*/0);
 		break;
 
 	case eventDispatcher::EventType::KEY_RELEASE:
-		release_(ch);
+		if (!e.rt)
+			release_(ch, /*localFrame=*/0);
 		break;
 
 	case eventDispatcher::EventType::KEY_KILL:
-		kill_(ch);
+		if (!e.rt)
+			kill_(ch);
 		break;
 
 	case eventDispatcher::EventType::SEQUENCER_STOP:
@@ -257,4 +284,30 @@ void react(channel::Data& ch, const eventDispatcher::Event& e)
 		break;
 	}
 }
+/* -------------------------------------------------------------------------- */
+
+void reactRt(const channel::Data& ch, const eventDispatcher::Event& e)
+{
+	if (!ch.hasWave())
+		return;
+
+	switch (e.type)
+	{
+
+	case eventDispatcher::EventType::KEY_PRESS:
+		press_(ch, std::get<int>(e.data), e.delta);
+		break;
+
+	case eventDispatcher::EventType::KEY_RELEASE:
+		release_(ch, e.delta);
+		break;
+
+	case eventDispatcher::EventType::KEY_KILL:
+		kill_(ch, e.delta);
+		break;
+
+	default:
+		break;
+	}
+}
 } // namespace giada::m::sampleReactor
\ No newline at end of file
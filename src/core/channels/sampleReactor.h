@@ -46,6 +46,12 @@ struct Data
 };
 
 void react(channel::Data& ch, const eventDispatcher::Event& e);
+
+/* reactRt
+[realtime] Plays or stops the channel at frame 'e.delta' of the current block.
+Key events only. */
+
+void reactRt(const channel::Data& ch, const eventDispatcher::Event& e);
 } // namespace giada::m::sampleReactor
 
 #endif
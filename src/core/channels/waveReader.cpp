@@ -28,65 +28,17 @@
 #include "core/audioBuffer.h"
 #include "core/const.h"
 #include "core/model/model.h"
+#include "core/resamplerPool.h"
 #include "core/wave.h"
-#include "utils/log.h"
 #include <algorithm>
 #include <cassert>
-#include <memory>
 
 namespace giada::m
 {
-WaveReader::WaveReader()
-: wave(nullptr)
-, m_srcState(nullptr)
+WaveReader::WaveReader(ID channelId, Wave* w)
+: wave(w)
+, m_srcState(resamplerPool::get(channelId))
 {
-	allocateSrc();
-}
-
-/* -------------------------------------------------------------------------- */
-
-WaveReader::WaveReader(const WaveReader& o)
-: wave(o.wave)
-, m_srcState(nullptr)
-{
-	allocateSrc();
-}
-
-/* -------------------------------------------------------------------------- */
-
-WaveReader::WaveReader(WaveReader&& o)
-: wave(o.wave)
-, m_srcState(nullptr)
-{
-	moveSrc(&o.m_srcState);
-}
-
-/* -------------------------------------------------------------------------- */
-
-WaveReader& WaveReader::operator=(const WaveReader& o)
-{
-	if (this == &o)
-		return *this;
-	wave = o.wave;
-	allocateSrc();
-	return *this;
-}
-
-WaveReader& WaveReader::operator=(WaveReader&& o)
-{
-	if (this == &o)
-		return *this;
-	wave = o.wave;
-	moveSrc(&o.m_srcState);
-	return *this;
-}
-
-/* -------------------------------------------------------------------------- */
-
-WaveReader::~WaveReader()
-{
-	if (m_srcState != nullptr)
-		src_delete(m_srcState);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -136,26 +88,4 @@ WaveReader::Result WaveReader::fillCopy(AudioBuffer& dest, Frame start, Frame ma
 
 	return {used, used};
 }
-
-/* -------------------------------------------------------------------------- */
-
-void WaveReader::allocateSrc()
-{
-	m_srcState = src_new(SRC_LINEAR, G_MAX_IO_CHANS, nullptr);
-	if (m_srcState == nullptr)
-	{
-		u::log::print("[WaveReader] unable to allocate memory for SRC_STATE!\n");
-		throw std::bad_alloc();
-	}
-}
-
-/* -------------------------------------------------------------------------- */
-
-void WaveReader::moveSrc(SRC_STATE** other)
-{
-	if (m_srcState != nullptr)
-		src_delete(m_srcState);
-	m_srcState = *other;
-	*other     = nullptr;
-}
 } // namespace giada::m
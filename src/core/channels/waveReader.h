@@ -42,12 +42,11 @@ public:
 		Frame used, generated;
 	};
 
-	WaveReader();
-	WaveReader(const WaveReader& o);
-	WaveReader(WaveReader&&);
-	WaveReader& operator=(const WaveReader&);
-	WaveReader& operator=(WaveReader&&);
-	~WaveReader();
+	/* WaveReader
+	Builds a reader for channel 'channelId', borrowing its resampler from the
+	resamplerPool. Copies share the same resampler, so they are cheap. */
+
+	WaveReader(ID channelId, Wave* w = nullptr);
 
 	/* fill
 	Fills audio buffer 'out' with data coming from Wave, copying it from 'start'
@@ -64,11 +63,8 @@ public:
 	Result fillResampled(AudioBuffer& out, Frame start, Frame max, Frame offset, float pitch) const;
 	Result fillCopy(AudioBuffer& out, Frame start, Frame max, Frame offset) const;
 
-	void allocateSrc();
-	void moveSrc(SRC_STATE** o);
-
-	/* srcState
-	Struct from libsamplerate. */
+	/* m_srcState
+	Struct from libsamplerate, owned by the resamplerPool. */
 
 	SRC_STATE* m_srcState;
 };
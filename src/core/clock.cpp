@@ -27,16 +27,22 @@
 #include "clock.h"
 #include "core/conf.h"
 #include "core/const.h"
+#include "core/delayLockedLoop.h"
+#include "core/eventDispatcher.h"
 #include "core/kernelAudio.h"
 #include "core/kernelMidi.h"
+#include "core/midiSync.h"
+#include "core/mixer.h"
 #include "core/mixerHandler.h"
 #include "core/model/model.h"
 #include "core/sequencer.h"
 #include "glue/events.h"
 #include "glue/main.h"
 #include "utils/math.h"
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cmath>
 
 namespace giada::m::clock
 {
@@ -47,14 +53,31 @@ Tells how many frames to wait to perform a quantized action. */
 
 int quantizerStep_ = 1;
 
-/* midiTC*
-MIDI timecode variables. */
+/* midiSync_
+MIDI clock and timecode generator. */
 
-int midiTCrate_    = 0; // Send MTC data every midiTCrate_ frames
-int midiTCframes_  = 0;
-int midiTCseconds_ = 0;
-int midiTCminutes_ = 0;
-int midiTChours_   = 0;
+MidiSync midiSync_;
+
+/* TICKS_PER_BEAT
+MIDI clock resolution. */
+
+constexpr int TICKS_PER_BEAT = 24;
+
+/* midiClockDll_, midiClockTicks_, midiClockBpm_, midiClockPos_
+MIDI clock slave: filter for the incoming ticks, ticks received since the last
+lock, last tempo applied and ticks received since the last start (-1 if 
+unknown, e.g. after a continue). Used by the MIDI input thread only. */
+
+DelayLockedLoop midiClockDll_(G_MIDI_SLAVE_BANDWIDTH);
+int             midiClockTicks_ = 0;
+float           midiClockBpm_   = 0.0f;
+int             midiClockPos_   = -1;
+
+/* midiClockNudge_
+MIDI clock slave: phase error still to be corrected, in frames. Set by the MIDI
+input thread, consumed by the audio thread in takeNudge(). */
+
+std::atomic<Frame> midiClockNudge_ = 0;
 
 #ifdef WITH_AUDIO_JACK
 kernelAudio::JackState jackStatePrev_;
@@ -62,6 +85,91 @@ kernelAudio::JackState jackStatePrev_;
 
 /* -------------------------------------------------------------------------- */
 
+/* followMidiClockTempo_
+Applies the tempo estimate of the filter when it moves away from the current
+tempo by more than G_MIDI_SLAVE_TOLERANCE, just to skip pointless updates. 
+Recorded actions are not rescaled while following, see c::main::followBpm(). */
+
+void followMidiClockTempo_()
+{
+	const float bpm = static_cast<float>(60.0 / (midiClockDll_.getPeriod() * TICKS_PER_BEAT));
+
+	if (std::abs(bpm - midiClockBpm_) <= midiClockBpm_ * G_MIDI_SLAVE_TOLERANCE)
+		return;
+
+	midiClockBpm_ = bpm;
+	eventDispatcher::pumpEvent({eventDispatcher::EventType::FUNCTION, 0, 0, [bpm]() {
+		                            c::main::followBpm(bpm);
+	                            }});
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* followMidiClockPhase_
+Compares the frame being heard when the last tick was sent, according to the
+filter, with the frame that tick stands for. The difference is corrected by 
+the audio thread a little at a time, see takeNudge(). Only while running and
+if the position of the ticks is known, i.e. after a start. */
+
+void followMidiClockPhase_()
+{
+	using namespace std::chrono;
+
+	const model::Clock& c = model::get().clock;
+
+	if (midiClockPos_ <= 0 || c.status != ClockStatus::RUNNING || c.framesInLoop <= 0)
+		return;
+
+	const int   tick     = (midiClockPos_ - 1) % (TICKS_PER_BEAT * c.beats);
+	const Frame expected = static_cast<Frame>(std::llround(tick * static_cast<double>(c.framesInBeat) / TICKS_PER_BEAT));
+	const auto  time     = steady_clock::time_point(duration_cast<steady_clock::duration>(duration<double>(midiClockDll_.getTime())));
+
+	/* Take the shortest way around the loop. */
+
+	Frame error = (expected - getFrameAt(time)) % c.framesInLoop;
+	if (error > c.framesInLoop / 2)
+		error -= c.framesInLoop;
+	else if (error < -c.framesInLoop / 2)
+		error += c.framesInLoop;
+
+	midiClockNudge_.store(error);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* endFollowMidiClock_
+Rescales recorded actions to the tempo followed so far, once per transport 
+change. */
+
+void endFollowMidiClock_()
+{
+	eventDispatcher::pumpEvent({eventDispatcher::EventType::FUNCTION, 0, 0, []() {
+		                            c::main::endFollowBpm();
+	                            }});
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* recvMidiClockTick_
+Feeds a MIDI clock tick to the filter. Once it has settled for a beat, tempo
+and phase follow the filtered ticks. */
+
+void recvMidiClockTick_(std::chrono::steady_clock::time_point t)
+{
+	midiClockDll_.tick(std::chrono::duration<double>(t.time_since_epoch()).count());
+	midiClockTicks_ = midiClockDll_.isLocked() ? midiClockTicks_ + 1 : 0;
+	if (midiClockPos_ >= 0)
+		midiClockPos_++;
+
+	if (midiClockTicks_ < TICKS_PER_BEAT)
+		return;
+
+	followMidiClockTempo_();
+	followMidiClockPhase_();
+}
+
+/* -------------------------------------------------------------------------- */
+
 /* recomputeFrames_
 Updates bpm, frames, beats and so on. Private version. */
 
@@ -83,7 +191,7 @@ void recomputeFrames_(model::Clock& c)
 
 void init(int sampleRate, float midiTCfps)
 {
-	midiTCrate_ = static_cast<int>((sampleRate / midiTCfps) * G_MAX_IO_CHANS); // stereo values
+	midiSync_.setup(sampleRate, midiTCfps);
 
 	model::get().clock.bars     = G_DEFAULT_BARS;
 	model::get().clock.beats    = G_DEFAULT_BEATS;
@@ -233,7 +341,7 @@ void rewind()
 
 /* -------------------------------------------------------------------------- */
 
-void sendMIDIsync()
+void sendMIDIsync(Frame bufferSize)
 {
 	const model::Clock& c = model::get().clock;
 
@@ -242,86 +350,20 @@ void sendMIDIsync()
 	if (c.status == ClockStatus::WAITING)
 		return;
 
-	int currentFrame = c.state->currentFrame.load();
-
 	/* TODO - only Master (_M) is implemented so far. */
 
-	if (conf::conf.midiSync == MIDI_SYNC_CLOCK_M)
-	{
-		if (currentFrame % (c.framesInBeat / 24) == 0)
-			kernelMidi::send(MIDI_CLOCK, -1, -1);
-		return;
-	}
-
-	if (conf::conf.midiSync == MIDI_SYNC_MTC_M)
-	{
-
-		/* check if a new timecode frame has passed. If so, send MIDI TC
-		 * quarter frames. 8 quarter frames, divided in two branches:
-		 * 1-4 and 5-8. We check timecode frame's parity: if even, send
-		 * range 1-4, if odd send 5-8. */
-
-		if (currentFrame % midiTCrate_ != 0) // no timecode frame passed
-			return;
-
-		/* frame low nibble
-		 * frame high nibble
-		 * seconds low nibble
-		 * seconds high nibble */
+	const MidiSync::Messages& messages = midiSync_.advance(conf::conf.midiSync,
+	    c.state->currentFrame.load(), bufferSize, c.framesInLoop, c.framesInBeat);
 
-		if (midiTCframes_ % 2 == 0)
-		{
-			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCframes_ & 0x0F) | 0x00, -1);
-			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCframes_ >> 4) | 0x10, -1);
-			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCseconds_ & 0x0F) | 0x20, -1);
-			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCseconds_ >> 4) | 0x30, -1);
-		}
-
-		/* minutes low nibble
-		 * minutes high nibble
-		 * hours low nibble
-		 * hours high nibble SMPTE frame rate */
-
-		else
-		{
-			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCminutes_ & 0x0F) | 0x40, -1);
-			kernelMidi::send(MIDI_MTC_QUARTER, (midiTCminutes_ >> 4) | 0x50, -1);
-			kernelMidi::send(MIDI_MTC_QUARTER, (midiTChours_ & 0x0F) | 0x60, -1);
-			kernelMidi::send(MIDI_MTC_QUARTER, (midiTChours_ >> 4) | 0x70, -1);
-		}
-
-		midiTCframes_++;
-
-		/* check if total timecode frames are greater than timecode fps:
-		 * if so, a second has passed */
-
-		if (midiTCframes_ > conf::conf.midiTCfps)
-		{
-			midiTCframes_ = 0;
-			midiTCseconds_++;
-			if (midiTCseconds_ >= 60)
-			{
-				midiTCminutes_++;
-				midiTCseconds_ = 0;
-				if (midiTCminutes_ >= 60)
-				{
-					midiTChours_++;
-					midiTCminutes_ = 0;
-				}
-			}
-			//u::log::print("%d:%d:%d:%d\n", midiTChours_, midiTCminutes_, midiTCseconds_, midiTCframes_);
-		}
-	}
+	for (const MidiSync::Message& m : messages)
+		kernelMidi::sendAt(m.delta, m.b1, m.b2);
 }
 
 /* -------------------------------------------------------------------------- */
 
 void sendMIDIrewind()
 {
-	midiTCframes_  = 0;
-	midiTCseconds_ = 0;
-	midiTCminutes_ = 0;
-	midiTChours_   = 0;
+	midiSync_.rewind();
 
 	/* For cueing the slave to a particular start point, Quarter Frame
 	 * messages are not used. Instead, an MTC Full Frame message should
@@ -341,6 +383,48 @@ void sendMIDIrewind()
 
 /* -------------------------------------------------------------------------- */
 
+void recvMidiSync(int status, std::chrono::steady_clock::time_point t)
+{
+	if (conf::conf.midiSync != MIDI_SYNC_CLOCK_S)
+		return;
+
+	switch (status)
+	{
+	case MIDI_CLOCK:
+		recvMidiClockTick_(t);
+		break;
+
+	case MIDI_START:
+		midiClockDll_.reset();
+		midiClockTicks_ = 0;
+		midiClockPos_   = 0; // The next tick is on the first beat
+		midiClockNudge_.store(0);
+		endFollowMidiClock_();
+		c::events::rewindSequencer(Thread::MIDI);
+		c::events::startSequencer(Thread::MIDI);
+		break;
+
+	case MIDI_CONTINUE:
+		midiClockPos_ = -1;
+		midiClockNudge_.store(0);
+		endFollowMidiClock_();
+		c::events::startSequencer(Thread::MIDI);
+		break;
+
+	case MIDI_STOP:
+		midiClockPos_ = -1;
+		midiClockNudge_.store(0);
+		c::events::stopSequencer(Thread::MIDI);
+		endFollowMidiClock_();
+		break;
+
+	default:
+		break;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
 #ifdef WITH_AUDIO_JACK
 
 void recvJackSync()
@@ -397,6 +481,28 @@ Frame quantize(Frame f)
 
 /* -------------------------------------------------------------------------- */
 
+Frame getFrameAt(std::chrono::steady_clock::time_point t)
+{
+	const Frame framesInLoop = getFramesInLoop();
+	const Frame frame        = mixer::getBlockPosition(t) - static_cast<Frame>(kernelAudio::getOutputLatency());
+
+	if (framesInLoop <= 0)
+		return std::max(frame, 0);
+	return ((frame % framesInLoop) + framesInLoop) % framesInLoop;
+}
+
+/* -------------------------------------------------------------------------- */
+
+Frame takeNudge(Frame bufferSize)
+{
+	const Frame max   = std::max(static_cast<Frame>(bufferSize * G_MIDI_SLAVE_MAX_NUDGE), 1);
+	const Frame nudge = std::clamp(midiClockNudge_.load(), -max, max);
+	midiClockNudge_.fetch_sub(nudge);
+	return nudge;
+}
+
+/* -------------------------------------------------------------------------- */
+
 int         getCurrentFrame() { return model::get().clock.state->currentFrame.load(); }
 int         getCurrentBeat() { return model::get().clock.state->currentBeat.load(); }
 int         getQuantizerStep() { return quantizerStep_; }
@@ -28,6 +28,7 @@
 #define G_CLOCK_H
 
 #include "types.h"
+#include <chrono>
 
 namespace giada::m::clock
 {
@@ -39,15 +40,26 @@ Updates bpm, frames, beats and so on. */
 void recomputeFrames();
 
 /* sendMIDIsync
-Generates MIDI sync output data. */
+Generates MIDI sync output data for the next 'bufferSize' frames, each message
+scheduled at its own frame. Call this on each new audio block, before advancing
+the clock. */
 /*TODO - move this to giada::m::sync*/
-void sendMIDIsync();
+void sendMIDIsync(Frame bufferSize);
 
 /* sendMIDIrewind
 Rewinds timecode to beat 0 and also send a MTC full frame to cue the slave. */
 /*TODO - move this to giada::m::sync*/
 void sendMIDIrewind();
 
+/* recvMidiSync
+Follows an external MIDI clock, when in MIDI clock slave mode. 'status' is a 
+MIDI real-time message (clock, start, continue, stop) received at time 't'. 
+Tempo is estimated from the clock ticks and followed continuously, the phase 
+is kept in sync by nudging the playhead; transport messages start, stop and 
+rewind the sequencer. */
+/*TODO - move this to giada::m::sync*/
+void recvMidiSync(int status, std::chrono::steady_clock::time_point t);
+
 #if defined(G_OS_LINUX) || defined(G_OS_FREEBSD) || defined(G_OS_MAC)
 /*TODO - move this to giada::m::sync*/
 void recvJackSync();
@@ -93,6 +105,20 @@ Quantizes the global frame 'f'.  */
 
 Frame quantize(Frame f);
 
+/* getFrameAt
+Returns the frame in the loop the user was listening to at time 't', i.e. the
+frame being rendered at that time minus the output latency. Use it to place
+live events where they have been played, regardless of the buffer size. */
+
+Frame getFrameAt(std::chrono::steady_clock::time_point t);
+
+/* takeNudge
+[realtime] Returns how many frames the playhead has to move in a block of 
+'bufferSize' frames on top of the block itself, to stay in phase with an 
+external MIDI clock. At most G_MIDI_SLAVE_MAX_NUDGE of the block. */
+
+Frame takeNudge(Frame bufferSize);
+
 void setBpm(float b);
 void setBeats(int beats, int bars);
 void setQuantize(int q);
@@ -31,6 +31,7 @@
 #include "utils/fs.h"
 #include "utils/log.h"
 #include <FL/Fl.H>
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <string>
@@ -48,8 +49,10 @@ std::string confDirPath_  = "";
 
 void sanitize_()
 {
-	conf.soundDeviceOut = std::max(0, conf.soundDeviceOut);
-	conf.channelsOut    = std::max(0, conf.channelsOut);
+	conf.soundDeviceOut  = std::max(0, conf.soundDeviceOut);
+	conf.channelsOut     = std::max(0, conf.channelsOut);
+	conf.renderThreads   = std::clamp(conf.renderThreads, 1, G_MAX_RENDER_THREADS);
+	conf.pluginSleepTime = std::clamp(conf.pluginSleepTime, 0, G_MAX_PLUGIN_SLEEP_TIME);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -138,6 +141,9 @@ bool read()
 	conf.buffersize                 = j.value(CONF_KEY_BUFFER_SIZE, conf.buffersize);
 	conf.limitOutput                = j.value(CONF_KEY_LIMIT_OUTPUT, conf.limitOutput);
 	conf.rsmpQuality                = j.value(CONF_KEY_RESAMPLE_QUALITY, conf.rsmpQuality);
+	conf.renderThreads              = j.value(CONF_KEY_RENDER_THREADS, conf.renderThreads);
+	conf.pluginSleepTime            = j.value(CONF_KEY_PLUGIN_SLEEP_TIME, conf.pluginSleepTime);
+	conf.rtLiveEvents               = j.value(CONF_KEY_RT_LIVE_EVENTS, conf.rtLiveEvents);
 	conf.midiSystem                 = j.value(CONF_KEY_MIDI_SYSTEM, conf.midiSystem);
 	conf.midiPortOut                = j.value(CONF_KEY_MIDI_PORT_OUT, conf.midiPortOut);
 	conf.midiPortIn                 = j.value(CONF_KEY_MIDI_PORT_IN, conf.midiPortIn);
@@ -236,6 +242,9 @@ bool write()
 	j[CONF_KEY_BUFFER_SIZE]                   = conf.buffersize;
 	j[CONF_KEY_LIMIT_OUTPUT]                  = conf.limitOutput;
 	j[CONF_KEY_RESAMPLE_QUALITY]              = conf.rsmpQuality;
+	j[CONF_KEY_RENDER_THREADS]                = conf.renderThreads;
+	j[CONF_KEY_PLUGIN_SLEEP_TIME]             = conf.pluginSleepTime;
+	j[CONF_KEY_RT_LIVE_EVENTS]                = conf.rtLiveEvents;
 	j[CONF_KEY_MIDI_SYSTEM]                   = conf.midiSystem;
 	j[CONF_KEY_MIDI_PORT_OUT]                 = conf.midiPortOut;
 	j[CONF_KEY_MIDI_PORT_IN]                  = conf.midiPortIn;
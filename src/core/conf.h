@@ -48,6 +48,9 @@ struct Conf
 	int  buffersize      = G_DEFAULT_BUFSIZE;
 	bool limitOutput     = false;
 	int  rsmpQuality     = 0;
+	int  renderThreads   = G_DEFAULT_RENDER_THREADS;
+	int  pluginSleepTime = G_DEFAULT_PLUGIN_SLEEP_TIME;
+	bool rtLiveEvents    = false;
 
 	int         midiSystem  = 0;
 	int         midiPortOut = G_DEFAULT_MIDI_PORT_OUT;
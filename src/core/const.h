@@ -120,8 +120,27 @@ constexpr int   G_MAX_VELOCITY          = 0x7F;
 constexpr int   G_MAX_MIDI_CHANS        = 16;
 constexpr int   G_MAX_POLYPHONY         = 32;
 constexpr int   G_MAX_DISPATCHER_EVENTS = 32;
+constexpr int   G_DISPATCHER_TIMEOUT    = 5; // ms, when no wakeup comes in
+constexpr int   G_DISPATCHER_COALESCE   = 0; // ms, 0 = disabled
 constexpr int   G_MAX_SEQUENCER_EVENTS  = 128; // Per block
+constexpr int   G_MAX_PARAM_CHANGES     = 16;  // Per channel, per block
 constexpr int   G_MAX_QUANTIZER_SIZE    = 32;
+constexpr int   G_MAX_RENDER_THREADS    = 16;
+constexpr int   G_AUDIO_THREAD_PRIORITY = 70; // Realtime, audio thread and render helpers
+constexpr int   G_RESAMPLER_POOL_SIZE   = 64; // Preallocated, grows if needed
+constexpr int   G_MAX_LIVE_RECS         = 4096;
+constexpr int   G_LIVE_RECS_DRAIN_TIME  = 50; // ms
+constexpr float G_BLOCK_CLOCK_SMOOTHING = 0.05f; // Weight of each new block time
+constexpr int   G_MIDI_STAMP_MAX_DRIFT  = 10;    // ms
+constexpr int   G_MAX_MIDI_OUT_EVENTS   = 1024;
+constexpr int   G_MAX_SYNC_MESSAGES     = 64; // Per block
+constexpr float G_MIDI_SLAVE_BANDWIDTH  = 0.5f;   // Hz, of the MIDI clock DLL
+constexpr float G_MIDI_SLAVE_TOLERANCE  = 0.0001f; // Smallest tempo change to follow, relative
+constexpr float G_MIDI_SLAVE_MAX_NUDGE  = 0.01f;   // Phase correction per block, relative
+constexpr int   G_MIDI_OUT_POLL         = 1; // ms, output queue polling
+constexpr int   G_MIDI_OUT_LATE_TIME    = 1; // ms, past the scheduled time
+constexpr int   G_MAX_PLUGIN_SLEEP_TIME = 10000;     // ms
+constexpr float G_PLUGIN_SLEEP_LEVEL    = 0.0000316f; // -90 dB
 
 /* -- kernel audio ---------------------------------------------------------- */
 constexpr int G_SYS_API_NONE   = 0x00; // 0000 0000
@@ -173,6 +192,8 @@ constexpr float G_DEFAULT_REC_TRIGGER_LEVEL   = -10.0f;
 constexpr int   G_DEFAULT_SUBWINDOW_W         = 640;
 constexpr int   G_DEFAULT_SUBWINDOW_H         = 480;
 constexpr int   G_DEFAULT_VST_MIDIBUFFER_SIZE = 1024; // TODO - not 100% sure about this size
+constexpr int   G_DEFAULT_RENDER_THREADS      = 1;    // audio thread only
+constexpr int   G_DEFAULT_PLUGIN_SLEEP_TIME   = 2000; // ms, 0 = never sleep
 
 /* -- responses and return codes -------------------------------------------- */
 constexpr int G_RES_ERR_PROCESSING    = -6;
@@ -375,6 +396,9 @@ constexpr auto CONF_KEY_BUFFER_SIZE                   = "buffer_size";
 constexpr auto CONF_KEY_DELAY_COMPENSATION            = "delay_compensation";
 constexpr auto CONF_KEY_LIMIT_OUTPUT                  = "limit_output";
 constexpr auto CONF_KEY_RESAMPLE_QUALITY              = "resample_quality";
+constexpr auto CONF_KEY_RENDER_THREADS                = "render_threads";
+constexpr auto CONF_KEY_PLUGIN_SLEEP_TIME             = "plugin_sleep_time";
+constexpr auto CONF_KEY_RT_LIVE_EVENTS                = "rt_live_events";
 constexpr auto CONF_KEY_MIDI_SYSTEM                   = "midi_system";
 constexpr auto CONF_KEY_MIDI_PORT_OUT                 = "midi_port_out";
 constexpr auto CONF_KEY_MIDI_PORT_IN                  = "midi_port_in";
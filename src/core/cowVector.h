@@ -0,0 +1,195 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_COW_VECTOR_H
+#define G_COW_VECTOR_H
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace giada
+{
+/* CowVector
+A vector whose elements live in shared, heap-allocated nodes. Copying a 
+CowVector only copies the node pointers, so the copy shares all its elements 
+with the original (structural sharing). An element is cloned the first time 
+it is accessed through a non-const method while shared (copy-on-write): the 
+other copies never see the change.
+
+Const access never allocates nor touches reference counters, so it is safe for
+the realtime thread reading a CowVector that no one else is writing. Non-const 
+access may allocate: use it only on the thread that owns the writable copy. */
+
+template <typename T>
+class CowVector
+{
+	using Node  = std::shared_ptr<T>;
+	using Nodes = std::vector<Node>;
+
+public:
+	/* iterator
+	Mutable iterator: dereferencing it makes the element unique first. */
+
+	class iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type        = T;
+		using difference_type   = std::ptrdiff_t;
+		using pointer           = T*;
+		using reference         = T&;
+
+		iterator(typename Nodes::iterator it)
+		: m_it(it)
+		{
+		}
+
+		T& operator*() const { return makeUnique(*m_it); }
+		T* operator->() const { return &makeUnique(*m_it); }
+
+		iterator& operator++()
+		{
+			++m_it;
+			return *this;
+		}
+
+		iterator operator++(int)
+		{
+			iterator tmp = *this;
+			++m_it;
+			return tmp;
+		}
+
+		bool operator==(const iterator& o) const { return m_it == o.m_it; }
+		bool operator!=(const iterator& o) const { return m_it != o.m_it; }
+
+	private:
+		typename Nodes::iterator m_it;
+	};
+
+	/* const_iterator
+	Read-only iterator: no copies, no reference counting. */
+
+	class const_iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type        = T;
+		using difference_type   = std::ptrdiff_t;
+		using pointer           = const T*;
+		using reference         = const T&;
+
+		const_iterator(typename Nodes::const_iterator it)
+		: m_it(it)
+		{
+		}
+
+		const T& operator*() const { return **m_it; }
+		const T* operator->() const { return m_it->get(); }
+
+		const_iterator& operator++()
+		{
+			++m_it;
+			return *this;
+		}
+
+		const_iterator operator++(int)
+		{
+			const_iterator tmp = *this;
+			++m_it;
+			return tmp;
+		}
+
+		bool operator==(const const_iterator& o) const { return m_it == o.m_it; }
+		bool operator!=(const const_iterator& o) const { return m_it != o.m_it; }
+
+	private:
+		typename Nodes::const_iterator m_it;
+	};
+
+	iterator       begin() { return iterator(m_nodes.begin()); }
+	iterator       end() { return iterator(m_nodes.end()); }
+	const_iterator begin() const { return const_iterator(m_nodes.cbegin()); }
+	const_iterator end() const { return const_iterator(m_nodes.cend()); }
+	const_iterator cbegin() const { return const_iterator(m_nodes.cbegin()); }
+	const_iterator cend() const { return const_iterator(m_nodes.cend()); }
+
+	T&       operator[](std::size_t i) { return makeUnique(m_nodes[i]); }
+	const T& operator[](std::size_t i) const { return *m_nodes[i]; }
+
+	T&       back() { return makeUnique(m_nodes.back()); }
+	const T& back() const { return *m_nodes.back(); }
+
+	std::size_t size() const { return m_nodes.size(); }
+	bool        empty() const { return m_nodes.empty(); }
+
+	void push_back(T t)
+	{
+		m_nodes.push_back(std::make_shared<T>(std::move(t)));
+	}
+
+	void clear()
+	{
+		m_nodes.clear();
+	}
+
+	/* removeIf
+	Removes all elements for which 'f(const T&)' returns true. Remaining 
+	elements are not copied. */
+
+	template <typename F>
+	void removeIf(F&& f)
+	{
+		m_nodes.erase(std::remove_if(m_nodes.begin(), m_nodes.end(),
+		                  [&f](const Node& n) { return f(static_cast<const T&>(*n)); }),
+		    m_nodes.end());
+	}
+
+	/* isShared
+	Tells whether the i-th element is shared with another CowVector. */
+
+	bool isShared(std::size_t i) const
+	{
+		return m_nodes[i].use_count() > 1;
+	}
+
+private:
+	static T& makeUnique(Node& n)
+	{
+		assert(n != nullptr);
+		if (n.use_count() > 1)
+			n = std::make_shared<T>(static_cast<const T&>(*n));
+		return *n;
+	}
+
+	Nodes m_nodes;
+};
+} // namespace giada
+
+#endif
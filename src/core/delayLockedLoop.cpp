@@ -0,0 +1,115 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/delayLockedLoop.h"
+#include <cmath>
+
+namespace giada::m
+{
+namespace
+{
+constexpr double PI = 3.14159265358979323846;
+
+/* MAX_ERROR
+A tick further than this many periods from the prediction means the signal 
+has been interrupted: start over. */
+
+constexpr double MAX_ERROR = 4.0;
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+DelayLockedLoop::DelayLockedLoop(double bandwidth)
+: m_bandwidth(bandwidth)
+{
+	reset();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void DelayLockedLoop::reset()
+{
+	m_ticks = 0;
+	m_t0    = 0.0;
+	m_t1    = 0.0;
+	m_e2    = 0.0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void DelayLockedLoop::tick(double t)
+{
+	/* The first two ticks give a raw estimate of the period to start from. */
+
+	if (m_ticks == 0)
+	{
+		m_t0 = t;
+		m_ticks++;
+		return;
+	}
+	if (m_ticks == 1)
+	{
+		m_e2 = t - m_t0;
+		m_t0 = t;
+		m_t1 = t + m_e2;
+		if (m_e2 > 0.0)
+			m_ticks++;
+		else
+			reset();
+		return;
+	}
+
+	const double error = t - m_t1;
+
+	if (std::abs(error) > m_e2 * MAX_ERROR)
+	{
+		reset();
+		tick(t);
+		return;
+	}
+
+	/* Loop coefficients are recomputed on each tick, as the period may 
+	change. */
+
+	const double omega = 2.0 * PI * m_bandwidth * m_e2;
+	const double b     = std::sqrt(2.0) * omega;
+	const double c     = omega * omega;
+
+	m_t0 = m_t1;
+	m_t1 += b * error + m_e2;
+	m_e2 += c * error;
+	m_ticks++;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool   DelayLockedLoop::isLocked() const { return m_ticks >= 2; }
+double DelayLockedLoop::getPeriod() const { return m_e2; }
+double DelayLockedLoop::getTime() const { return m_t0; }
+double DelayLockedLoop::getNextTime() const { return m_t1; }
+} // namespace giada::m
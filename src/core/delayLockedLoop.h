@@ -0,0 +1,80 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_DELAY_LOCKED_LOOP_H
+#define G_DELAY_LOCKED_LOOP_H
+
+namespace giada::m
+{
+/* DelayLockedLoop
+Second order delay-locked loop, filters the timestamps of a periodic signal 
+(e.g. MIDI clock ticks) to estimate its period and phase without the jitter. 
+'bandwidth', in Hz, sets the tradeoff: lower values filter more jitter, but 
+follow period changes more slowly. Based on F. Adriaensen, "Using a DLL to 
+filter time" (2005). */
+
+class DelayLockedLoop
+{
+public:
+	DelayLockedLoop(double bandwidth);
+
+	/* reset
+	Forgets the signal: the loop starts over with the next tick. */
+
+	void reset();
+
+	/* tick
+	Feeds the time 't' of a new tick, in seconds. */
+
+	void tick(double t);
+
+	/* isLocked
+	True when there are enough ticks for an estimate. */
+
+	bool isLocked() const;
+
+	/* getPeriod
+	Returns the filtered period, in seconds. */
+
+	double getPeriod() const;
+
+	/* getTime, getNextTime
+	Return the filtered time of the last tick and the predicted time of the 
+	next one, in seconds. */
+
+	double getTime() const;
+	double getNextTime() const;
+
+private:
+	double m_bandwidth;
+	int    m_ticks;
+	double m_t0; // Filtered time of the last tick
+	double m_t1; // Predicted time of the next tick
+	double m_e2; // Filtered period
+};
+} // namespace giada::m
+
+#endif
@@ -0,0 +1,82 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+#include "core/envelope.h"
+#include <cassert>
+
+namespace giada::m
+{
+void Envelope::add(Frame frame, float gain)
+{
+	assert(m_points.empty() || frame >= m_points.back().frame);
+
+	/* Vertical segments (two points on the same frame) have no slope: the gain
+	just jumps to the new value. */
+
+	if (!m_points.empty())
+	{
+		Point&      prev   = m_points.back();
+		const Frame length = frame - prev.frame;
+		prev.step          = length > 0 ? (gain - prev.gain) / length : 0.0f;
+	}
+
+	m_points.push_back({frame, gain, 0.0f});
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool Envelope::isEmpty() const
+{
+	return m_points.empty();
+}
+
+/* -------------------------------------------------------------------------- */
+
+float Envelope::getGain(Frame f) const
+{
+	assert(!m_points.empty());
+	return getGain_(findNext_(f), f);
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::size_t Envelope::findNext_(Frame f) const
+{
+	auto it = std::upper_bound(m_points.begin(), m_points.end(), f,
+	    [](Frame f, const Point& p) { return f < p.frame; });
+	return it - m_points.begin();
+}
+
+/* -------------------------------------------------------------------------- */
+
+float Envelope::getGain_(std::size_t next, Frame f) const
+{
+	if (next == 0)
+		return m_points.front().gain;
+
+	const Point& prev = m_points[next - 1];
+	return prev.gain + prev.step * (f - prev.frame);
+}
+} // namespace giada::m
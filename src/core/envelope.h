@@ -0,0 +1,129 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+#ifndef G_ENVELOPE_H
+#define G_ENVELOPE_H
+
+#include "core/types.h"
+#include <algorithm>
+#include <vector>
+
+namespace giada::m
+{
+/* Envelope
+A piecewise linear gain curve over the loop, compiled from the points of a 
+recorded envelope. Each point also stores the slope towards the next one, so 
+that the curve can be rendered as a list of gain ramps without any division on
+the realtime thread. Before the first point and after the last one the gain is 
+held constant. */
+
+class Envelope
+{
+public:
+	/* Segment
+	A linear piece of the envelope within a block: 'count' frames starting at
+	block offset 'offset', with gain 'gain' on the first frame, changing by 
+	'step' on each frame. */
+
+	struct Segment
+	{
+		Frame offset;
+		Frame count;
+		float gain;
+		float step;
+	};
+
+	/* add
+	Appends a new point. Points must be added sorted by frame. */
+
+	void add(Frame frame, float gain);
+
+	bool isEmpty() const;
+
+	/* getGain
+	Returns the gain on frame 'f'. */
+
+	float getGain(Frame f) const;
+
+	/* forEachSegment
+	Calls 'f(const Segment&)' on each linear piece of the envelope found in a 
+	block of 'count' frames, starting from frame 'start' of a loop of 
+	'framesInLoop' frames. Wraps around the loop end. Costs a binary search plus
+	O(segments in block). */
+
+	template <typename F>
+	void forEachSegment(Frame start, Frame count, Frame framesInLoop, F&& f) const
+	{
+		if (m_points.empty() || framesInLoop <= 0)
+			return;
+
+		Frame       frame  = start % framesInLoop;
+		Frame       offset = 0;
+		std::size_t next   = findNext_(frame);
+
+		while (offset < count)
+		{
+			while (next < m_points.size() && m_points[next].frame <= frame)
+				next++;
+
+			const Frame end    = next < m_points.size() ? std::min(m_points[next].frame, framesInLoop) : framesInLoop;
+			const Frame length = std::min(end - frame, count - offset);
+
+			f(Segment{offset, length, getGain_(next, frame), next == 0 ? 0.0f : m_points[next - 1].step});
+
+			offset += length;
+			frame += length;
+
+			if (frame >= framesInLoop)
+			{
+				frame = 0;
+				next  = 0;
+			}
+		}
+	}
+
+private:
+	struct Point
+	{
+		Frame frame;
+		float gain;
+		float step; // Gain change per frame towards the next point
+	};
+
+	/* findNext_
+	Returns the index of the first point past frame 'f'. */
+
+	std::size_t findNext_(Frame f) const;
+
+	/* getGain_
+	Returns the gain on frame 'f', given the index of the first point past it. */
+
+	float getGain_(std::size_t next, Frame f) const;
+
+	std::vector<Point> m_points;
+};
+} // namespace giada::m
+
+#endif
@@ -26,11 +26,19 @@
 
 #include "eventDispatcher.h"
 #include "core/clock.h"
+#include "core/conf.h"
+#include "core/mixer.h"
 #include "core/model/model.h"
 #include "core/sequencer.h"
 #include "core/worker.h"
 #include "utils/log.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 namespace giada::m::eventDispatcher
 {
@@ -38,12 +46,119 @@ namespace
 {
 Worker worker_;
 
+/* overflows_
+Number of queue overflows reported so far, to log only the new ones. */
+
+std::size_t overflows_ = 0;
+
+/* latency[Count|Total|Max]_
+Push-to-apply latency stats, in microseconds. Written by the worker only. */
+
+std::atomic<std::size_t> latencyCount_(0);
+std::atomic<int64_t>     latencyTotal_(0);
+std::atomic<int64_t>     latencyMax_(0);
+
+/* midiTime_
+Arrival time of the MIDI message being processed, if any. See setMidiTime(). 
+Per thread, as MIDI events can be pumped by the MIDI input thread too. */
+
+thread_local std::chrono::steady_clock::time_point midiTime_ = {};
+
+/* incoming_
+Events just taken from the two event queues, before coalescing. */
+
+EventBuffer incoming_;
+
 /* eventBuffer_
 Buffer of events sent to channels for event parsing. This is filled with Events
-coming from the two event queues.*/
+coming from the two event queues, once coalesced. */
 
 EventBuffer eventBuffer_;
 
+/* routes_, broadcast_, channelEvents_
+Pointers to events in the event buffer: sorted by target channel, directed to
+all channels, and directed to the channel currently being processed. */
+
+std::vector<const Event*> routes_;
+std::vector<const Event*> broadcast_;
+std::vector<const Event*> channelEvents_;
+
+/* RouteCompare_
+Compares routed events and channel IDs, for binary searches in routes_. */
+
+struct RouteCompare_
+{
+	bool operator()(const Event* e, ID id) const { return e->channelId < id; }
+	bool operator()(ID id, const Event* e) const { return id < e->channelId; }
+};
+
+/* -------------------------------------------------------------------------- */
+
+/* isCoalescable_
+True if event 'e' carries an absolute parameter value: only the latest one per
+channel matters. */
+
+bool isCoalescable_(const Event& e)
+{
+	return e.type == EventType::CHANNEL_VOLUME ||
+	       e.type == EventType::CHANNEL_PAN ||
+	       e.type == EventType::CHANNEL_PITCH;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* isParameter_
+True if event 'e' only changes values that channels mirror in their State, 
+which is what the audio thread renders with. */
+
+bool isParameter_(const Event& e)
+{
+	return e.type == EventType::CHANNEL_VOLUME ||
+	       e.type == EventType::CHANNEL_PAN ||
+	       e.type == EventType::CHANNEL_MUTE;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* isSuperseded_
+True if there's an event newer than 'e' in the incoming buffer for the same
+channel and parameter. */
+
+bool isSuperseded_(const Event& e, std::size_t index)
+{
+	std::size_t i = 0;
+	for (const Event& o : incoming_)
+	{
+		const bool newer = o.pushTime > e.pushTime || (o.pushTime == e.pushTime && i > index);
+		if (newer && o.type == e.type && o.channelId == e.channelId)
+			return true;
+		i++;
+	}
+	return false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* coalesce_
+Fills the event buffer with incoming events, dropping parameter changes that
+are superseded by a newer one in the same batch. */
+
+void coalesce_()
+{
+	std::size_t i = 0;
+	for (const Event& e : incoming_)
+	{
+		if (!isCoalescable_(e) || !isSuperseded_(e, i))
+			eventBuffer_.push_back(e);
+		i++;
+	}
+
+	if (eventBuffer_.size() < incoming_.size())
+		G_DEBUG("[eventDispatcher] coalesced " << incoming_.size() << " events into "
+		                                       << eventBuffer_.size() << ", ratio="
+		                                       << incoming_.size() / static_cast<float>(eventBuffer_.size()));
+}
+
 /* -------------------------------------------------------------------------- */
 
 void processFuntions_()
@@ -58,11 +173,78 @@ void processFuntions_()
 
 /* -------------------------------------------------------------------------- */
 
+/* route_
+Sorts events in the buffer by target channel, so that each channel only looks 
+at its own events. Events for all channels go to the broadcast list. */
+
+void route_()
+{
+	routes_.clear();
+	broadcast_.clear();
+
+	for (const Event& e : eventBuffer_)
+	{
+		if (e.type == EventType::FUNCTION)
+			continue;
+		if (e.channelId == 0)
+			broadcast_.push_back(&e);
+		else
+			routes_.push_back(&e);
+	}
+
+	std::stable_sort(routes_.begin(), routes_.end(), [](const Event* a, const Event* b) {
+		return a->channelId < b->channelId;
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* collect_
+Fills 'channelEvents_' with events directed to channel 'channelId' plus the 
+broadcast ones, in the original order. Returns false if there are none. */
+
+bool collect_(ID channelId)
+{
+	auto [first, last] = std::equal_range(routes_.begin(), routes_.end(), channelId, RouteCompare_());
+
+	if (first == last && broadcast_.empty())
+		return false;
+
+	/* Events live in the same buffer: pointer order is arrival order. */
+
+	channelEvents_.clear();
+	std::merge(first, last, broadcast_.begin(), broadcast_.end(), std::back_inserter(channelEvents_));
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
 void processChannels_()
 {
-	for (channel::Data& ch : model::get().channels)
-		channel::react(ch, eventBuffer_, mixer::isChannelAudible(ch));
-	model::swap(model::SwapType::SOFT);
+	route_();
+
+	/* Access channels for writing only when they have something to react to:
+	the untouched ones keep being shared with the realtime layout, so the swap
+	below doesn't copy them. */
+
+	model::Layout& layout = model::get();
+	for (std::size_t i = 0; i < layout.channels.size(); i++)
+	{
+		if (!collect_(std::as_const(layout.channels)[i].id))
+			continue;
+		channel::Data& ch      = layout.channels[i];
+		const bool     audible = mixer::isChannelAudible(ch);
+		for (const Event* e : channelEvents_)
+			channel::react(ch, *e, audible);
+	}
+
+	/* Parameter-only batches (e.g. a slider being dragged) have already landed
+	in the channel State, which the audio thread reads directly: no need to
+	swap. The updated layout will be published by the next swap. */
+
+	const bool parametersOnly = std::all_of(eventBuffer_.begin(), eventBuffer_.end(), isParameter_);
+	if (!parametersOnly)
+		model::swap(model::SwapType::SOFT);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -74,22 +256,124 @@ void processSequencer_()
 
 /* -------------------------------------------------------------------------- */
 
+/* drain_
+Moves events from queue 'q' to the incoming buffer. Takes at most one queue worth
+of events, so that producers pushing while draining can't overflow the buffer:
+whatever is left will be processed in the next cycle. */
+
+void drain_(EventQueue& q)
+{
+	Event e;
+	for (int i = 0; i < G_MAX_DISPATCHER_EVENTS && q.pop(e); i++)
+		incoming_.push_back(e);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void checkOverflows_()
+{
+	std::size_t overflows = UIevents.countOverflows() + MidiEvents.countOverflows();
+	if (overflows == overflows_)
+		return;
+	u::log::print("[eventDispatcher] %zu events lost, queues full\n", overflows - overflows_);
+	overflows_ = overflows;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* measureLatency_
+Updates latency stats with the events just applied to the model. */
+
+void measureLatency_()
+{
+	const auto now = std::chrono::steady_clock::now();
+	for (const Event& e : eventBuffer_)
+	{
+		const int64_t latency = std::chrono::duration_cast<std::chrono::microseconds>(now - e.pushTime).count();
+		latencyCount_.fetch_add(1);
+		latencyTotal_.fetch_add(latency);
+		if (latency > latencyMax_.load())
+			latencyMax_.store(latency);
+		G_DEBUG("Event type=" << (int)e.type << ", push-to-apply latency=" << latency << " us");
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* canApplyRt_
+True if event 'e' can be applied by the audio thread. Not on internal channels
+(master in/out, preview): they don't render parameter changes within the
+block. */
+
+bool canApplyRt_(const Event& e)
+{
+	if (!conf::conf.rtLiveEvents || e.channelId == 0)
+		return false;
+	if (e.channelId == mixer::MASTER_OUT_CHANNEL_ID ||
+	    e.channelId == mixer::MASTER_IN_CHANNEL_ID ||
+	    e.channelId == mixer::PREVIEW_CHANNEL_ID)
+		return false;
+
+	switch (e.type)
+	{
+	case EventType::KEY_PRESS:
+	case EventType::KEY_RELEASE:
+	case EventType::KEY_KILL:
+	case EventType::CHANNEL_VOLUME:
+	case EventType::CHANNEL_PAN:
+	case EventType::CHANNEL_MUTE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* push_
+Stamps and pushes event 'e' to queue 'q', then wakes up the worker. Events 
+already stamped keep their time. If the event can be applied in realtime, it 
+goes to the audio thread too, but only once its place in 'q' is secured: the
+dispatcher must see every event the audio thread has applied, or Data and State
+would go out of sync. If the realtime push fails, the dispatcher will apply the
+event as usual. */
+
+bool push_(EventQueue& q, Event e)
+{
+	if (e.pushTime == std::chrono::steady_clock::time_point{})
+		e.pushTime = std::chrono::steady_clock::now();
+
+	const bool pushed = q.pushWith([&e]() -> const Event& {
+		if (canApplyRt_(e))
+			e.rt = RTevents.push(e);
+		return e;
+	});
+	if (!pushed)
+		return false;
+	worker_.notify();
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
 void process_()
 {
+	incoming_.clear();
 	eventBuffer_.clear();
 
-	Event e;
-	while (UIevents.pop(e))
-		eventBuffer_.push_back(e);
-	while (MidiEvents.pop(e))
-		eventBuffer_.push_back(e);
+	drain_(UIevents);
+	drain_(MidiEvents);
+	checkOverflows_();
 
-	if (eventBuffer_.size() == 0)
+	if (incoming_.size() == 0)
 		return;
 
+	coalesce_();
+
 	processFuntions_();
 	processChannels_();
 	processSequencer_();
+	measureLatency_();
 }
 } // namespace
 
@@ -97,22 +381,57 @@ void process_()
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-Queue<Event, G_MAX_DISPATCHER_EVENTS> UIevents;
-Queue<Event, G_MAX_DISPATCHER_EVENTS> MidiEvents;
+EventQueue UIevents;
+EventQueue MidiEvents;
+EventQueue RTevents;
 
 /* -------------------------------------------------------------------------- */
 
 void init()
 {
-	worker_.start(process_, /*sleep=*/5); // TODO - <= than audio thread speed
+	worker_.startSignalled(process_, G_DISPATCHER_TIMEOUT, G_DISPATCHER_COALESCE);
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool pumpEvent(Event e)
+{
+	/* Both the mixer/rt-thread and the main thread push events here: fine, 
+	UIevents is a multi-producer queue. */
+	return push_(UIevents, e);
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool pumpMidiEvent(Event e)
+{
+	e.pushTime = midiTime_;
+	return push_(MidiEvents, e);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void setMidiTime(std::chrono::steady_clock::time_point t)
+{
+	midiTime_ = t;
+}
+
+/* -------------------------------------------------------------------------- */
+
+LatencyStats getLatencyStats()
+{
+	const std::size_t count = latencyCount_.load();
+	if (count == 0)
+		return {};
+	return {count, latencyTotal_.load() / static_cast<float>(count), static_cast<float>(latencyMax_.load())};
 }
 
 /* -------------------------------------------------------------------------- */
 
-void pumpEvent(Event e)
+void resetLatencyStats()
 {
-	/* TODO - two threads push events here: mixer/rt-thread and main thread, so
-	this breaks the 1-producer 1-consumer rule! */
-	UIevents.push(e);
+	latencyCount_.store(0);
+	latencyTotal_.store(0);
+	latencyMax_.store(0);
 }
 } // namespace giada::m::eventDispatcher
\ No newline at end of file
@@ -29,10 +29,11 @@
 
 #include "core/action.h"
 #include "core/const.h"
-#include "core/queue.h"
+#include "core/mpmcQueue.h"
 #include "core/ringBuffer.h"
 #include "core/types.h"
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <thread>
 #include <variant>
@@ -71,26 +72,84 @@ struct Event
 	Frame     delta     = 0;
 	ID        channelId = 0;
 	EventData data;
+
+	/* pushTime
+	When the event has been pushed to the dispatcher, or when the originating
+	MIDI message has been received. Used to measure the push-to-apply latency
+	and to place live events within the audio block. */
+
+	std::chrono::steady_clock::time_point pushTime = {};
+
+	/* rt
+	True if the event has also been applied by the audio thread, in realtime 
+	live events mode. See RTevents below. */
+
+	bool rt = false;
+};
+
+/* LatencyStats
+Push-to-apply latency of the events processed so far, i.e. the time elapsed 
+between an event being pushed and its effects landing in the model, in 
+microseconds. */
+
+struct LatencyStats
+{
+	std::size_t count   = 0;
+	float       average = 0.0f;
+	float       max     = 0.0f;
 };
 
 /* EventBuffer
 Alias for a RingBuffer containing events to be sent to engine. The double size
-is due to the presence of two distinct Queues for collecting events coming from
+is due to the presence of two distinct queues for collecting events coming from
 other threads. See below. */
 
 using EventBuffer = RingBuffer<Event, G_MAX_DISPATCHER_EVENTS * 2>;
 
+/* EventQueue
+Multi-producer queue for events coming from other threads: the UI, the MIDI
+and the audio threads may push concurrently. */
+
+using EventQueue = MpmcQueue<Event, G_MAX_DISPATCHER_EVENTS>;
+
 /* Event queues
-Collect events coming from the UI or MIDI devices. Our poor's man Queue is a 
-single-producer/single-consumer one, so we need two queues for two writers. 
-TODO - let's add a multi-producer queue sooner or later! */
+Collect events coming from the UI or MIDI devices. Kept separate so that a
+burst of MIDI events can't starve the UI ones, and vice versa. Fill them with
+pumpEvent() and pumpMidiEvent(), which also wake up the dispatcher. */
+
+extern EventQueue UIevents;
+extern EventQueue MidiEvents;
 
-extern Queue<Event, G_MAX_DISPATCHER_EVENTS> UIevents;
-extern Queue<Event, G_MAX_DISPATCHER_EVENTS> MidiEvents;
+/* RTevents
+Live events consumed by the audio thread at the beginning of each block, when 
+conf::conf.rtLiveEvents is on: play/stop, volume, pan and mute are applied at 
+their exact frame within the block, with no layout swap. The same events are 
+still processed by the dispatcher to keep the layout in sync. */
+
+extern EventQueue RTevents;
 
 void init();
 
-void pumpEvent(Event e);
+/* pumpEvent, pumpMidiEvent
+Push an event to the UI or MIDI queue respectively and wake up the dispatcher.
+The event is forwarded to RTevents too, if it can be applied there. Lock-free, 
+can be called from any thread. Return false if the queue is full. */
+
+bool pumpEvent(Event e);
+bool pumpMidiEvent(Event e);
+
+/* setMidiTime
+Sets the arrival time of the MIDI message being processed: events pumped with
+pumpMidiEvent() get it as push time, so that they can be placed at the right 
+frame. Pass an empty time_point to go back to stamping events on push. Only 
+affects events pumped by the calling thread. */
+
+void setMidiTime(std::chrono::steady_clock::time_point t);
+
+/* getLatencyStats, resetLatencyStats */
+
+LatencyStats getLatencyStats();
+void         resetLatencyStats();
 } // namespace giada::m::eventDispatcher
 
 #endif
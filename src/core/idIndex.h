@@ -0,0 +1,97 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_ID_INDEX_H
+#define G_ID_INDEX_H
+
+#include "core/types.h"
+#include <cstddef>
+#include <vector>
+
+namespace giada
+{
+/* IdIndex
+Maps object IDs to their position in a container, for O(1) lookups. IDs are 
+small sequential integers (see IdManager), so this is a plain vector indexed by
+ID. The index is just a hint: lookups validate it against the container. If the
+container has changed since the last rebuild() the lookup falls back to a 
+linear search, still returning the right result. */
+
+class IdIndex
+{
+public:
+	/* rebuild
+	Indexes all elements in container 'c'. 'getId' returns the ID of an 
+	element. */
+
+	template <typename C, typename F>
+	void rebuild(const C& c, F getId)
+	{
+		m_positions.clear();
+		for (std::size_t i = 0; i < c.size(); i++)
+			set(getId(c[i]), static_cast<int>(i));
+	}
+
+	/* set
+	Indexes a single element with ID 'id' at position 'pos'. Cheaper than a 
+	full rebuild() when an element has just been appended. */
+
+	void set(ID id, int pos)
+	{
+		if (id < 0 || id >= MAX_ID) // Not worth a huge hole, search it linearly
+			return;
+		if (static_cast<std::size_t>(id) >= m_positions.size())
+			m_positions.resize(id + 1, -1);
+		m_positions[id] = pos;
+	}
+
+	/* find
+	Returns the position of the element with ID 'id' in container 'c', or -1 
+	if not found. */
+
+	template <typename C, typename F>
+	int find(const C& c, ID id, F getId) const
+	{
+		if (id >= 0 && static_cast<std::size_t>(id) < m_positions.size())
+		{
+			const int pos = m_positions[id];
+			if (pos >= 0 && static_cast<std::size_t>(pos) < c.size() && getId(c[pos]) == id)
+				return pos;
+		}
+		for (std::size_t i = 0; i < c.size(); i++)
+			if (getId(c[i]) == id)
+				return static_cast<int>(i);
+		return -1;
+	}
+
+private:
+	static constexpr ID MAX_ID = 1 << 16;
+
+	std::vector<int> m_positions;
+};
+} // namespace giada
+
+#endif
@@ -51,6 +51,7 @@
 #include "core/recManager.h"
 #include "core/recorder.h"
 #include "core/recorderHandler.h"
+#include "core/resamplerPool.h"
 #include "core/sequencer.h"
 #include "core/wave.h"
 #include "core/waveManager.h"
@@ -96,6 +97,7 @@ void initConf_()
 void initSystem_()
 {
 	model::init();
+	resamplerPool::init(G_RESAMPLER_POOL_SIZE);
 	eventDispatcher::init();
 }
 
@@ -113,7 +115,7 @@ void initAudio_()
 #ifdef WITH_VST
 
 	pluginManager::init(conf::conf.samplerate, kernelAudio::getRealBufSize());
-	pluginHost::init(kernelAudio::getRealBufSize());
+	pluginHost::init();
 
 #endif
 
@@ -258,6 +260,7 @@ void reset()
 #endif
 
 	model::init();
+	resamplerPool::releaseAll();
 	channelManager::init();
 	waveManager::init();
 	clock::init(conf::conf.samplerate, conf::conf.midiTCfps);
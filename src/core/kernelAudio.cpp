@@ -37,6 +37,7 @@
 #include "glue/main.h"
 #include "mixer.h"
 #include "utils/log.h"
+#include <cstdint>
 
 namespace giada::m::kernelAudio
 {
@@ -46,6 +47,7 @@ RtAudio* rtSystem     = nullptr;
 unsigned numDevs      = 0;
 bool     inputEnabled = false;
 unsigned realBufsize  = 0; // Real buffer size from the soundcard
+unsigned latency      = 0; // Stream latency reported by the driver, in frames
 int      api          = 0;
 
 #ifdef WITH_AUDIO_JACK
@@ -91,17 +93,19 @@ int callback_(void* outBuf, void* inBuf, unsigned bufferSize, double /*streamTim
 #endif
 
 	mixer::RenderInfo info;
-	info.isAudioReady    = model::get().kernel.audioReady;
-	info.hasInput        = isInputEnabled();
-	info.isClockActive   = clock::isActive();
-	info.isClockRunning  = clock::isRunning();
-	info.canLineInRec    = recManager::isRecordingInput() && isInputEnabled();
-	info.limitOutput     = conf::conf.limitOutput;
-	info.inToOut         = mh::getInToOut();
-	info.maxFramesToRec  = conf::conf.inputRecMode == InputRecMode::FREE ? clock::getMaxFramesInLoop() : clock::getFramesInLoop();
-	info.outVol          = mh::getOutVol();
-	info.inVol           = mh::getInVol();
-	info.recTriggerLevel = conf::conf.recTriggerLevel;
+	info.isAudioReady      = model::get().kernel.audioReady;
+	info.hasInput          = isInputEnabled();
+	info.isClockActive     = clock::isActive();
+	info.isClockRunning    = clock::isRunning();
+	info.canLineInRec      = recManager::isRecordingInput() && isInputEnabled();
+	info.limitOutput       = conf::conf.limitOutput;
+	info.inToOut           = mh::getInToOut();
+	info.maxFramesToRec    = conf::conf.inputRecMode == InputRecMode::FREE ? clock::getMaxFramesInLoop() : clock::getFramesInLoop();
+	info.pluginSleepFrames = static_cast<Frame>(static_cast<int64_t>(conf::conf.pluginSleepTime) * conf::conf.samplerate / 1000);
+	info.currentFrame      = clock::getCurrentFrame();
+	info.outVol            = mh::getOutVol();
+	info.inVol             = mh::getInVol();
+	info.recTriggerLevel   = conf::conf.recTriggerLevel;
 
 	return mixer::render(out, in, info);
 }
@@ -214,6 +218,8 @@ int openDevice()
 	RtAudio::StreamOptions options;
 	options.streamName      = G_APP_NAME;
 	options.numberOfBuffers = 4; // TODO - wtf?
+	options.flags           = RTAUDIO_SCHEDULE_REALTIME;
+	options.priority        = G_AUDIO_THREAD_PRIORITY; // Render helpers get the same, see mixer::init
 
 	realBufsize = conf::conf.buffersize;
 
@@ -258,7 +264,8 @@ int startStream()
 	try
 	{
 		rtSystem->startStream();
-		u::log::print("[KA] latency = %lu\n", rtSystem->getStreamLatency());
+		latency = rtSystem->getStreamLatency();
+		u::log::print("[KA] latency = %u\n", latency);
 		return 1;
 	}
 	catch (RtAudioError& e)
@@ -433,6 +440,8 @@ int getFreq(unsigned dev, int i)
 /* -------------------------------------------------------------------------- */
 
 unsigned getRealBufSize() { return realBufsize; }
+unsigned getStreamLatency() { return latency; }
+unsigned getOutputLatency() { return inputEnabled ? latency / 2 : latency; }
 bool     isInputEnabled() { return inputEnabled; }
 unsigned countDevices() { return numDevs; }
 
@@ -64,6 +64,7 @@ unsigned    getMaxInChans(int dev);
 unsigned    getMaxOutChans(unsigned dev);
 unsigned    getDuplexChans(unsigned dev);
 unsigned    getRealBufSize();
+unsigned    getStreamLatency();
 unsigned    countDevices();
 int         getTotalFreqs(unsigned dev);
 int         getFreq(unsigned dev, int i);
@@ -72,7 +73,16 @@ int         getDefaultOut();
 int         getDefaultIn();
 bool        hasAPI(int API);
 int         getAPI();
-void        logCompiledAPIs();
+
+/* getOutputLatency
+Returns the output latency of the stream, in frames. On duplex streams the 
+driver reports input and output latency summed together: both directions are
+opened with the same buffer size and number of buffers, so the output takes 
+half of it. */
+
+unsigned getOutputLatency();
+
+void logCompiledAPIs();
 
 #ifdef WITH_AUDIO_JACK
 
@@ -26,10 +26,21 @@
 
 #include "kernelMidi.h"
 #include "const.h"
+#include "core/clock.h"
+#include "core/kernelAudio.h"
+#include "core/mixer.h"
+#include "core/mpmcQueue.h"
+#include "core/worker.h"
 #include "midiDispatcher.h"
 #include "midiMapConf.h"
 #include "utils/log.h"
 #include <RtMidi.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 namespace giada
 {
@@ -46,8 +57,92 @@ RtMidiIn*  midiIn_      = nullptr;
 unsigned   numOutPorts_ = 0;
 unsigned   numInPorts_  = 0;
 
-static void callback_(double /*t*/, std::vector<unsigned char>* msg, void* /*data*/)
+/* OutMessage_
+A MIDI message to be sent at 'time' by the MIDI output thread. */
+
+struct OutMessage_
+{
+	std::array<unsigned char, 3>          bytes = {};
+	std::size_t                           size  = 0;
+	std::chrono::steady_clock::time_point time  = {};
+};
+
+/* outQueue_
+Messages coming from any thread, waiting to be picked up by the MIDI output
+thread. */
+
+MpmcQueue<OutMessage_, G_MAX_MIDI_OUT_EVENTS> outQueue_;
+
+/* outPending_, outBuffer_
+Messages taken from the queue, sorted by time, and the buffer passed to 
+RtMidi. Both owned by the MIDI output thread. */
+
+std::vector<OutMessage_>   outPending_;
+std::vector<unsigned char> outBuffer_;
+
+/* outWorker_
+The MIDI output thread. RtMidiOut::sendMessage() is a blocking system call: 
+it's only ever called from here. */
+
+Worker outWorker_;
+
+/* outDepth_, outSent_, outLate_
+Output queue stats. See OutStats. */
+
+std::atomic<std::size_t> outDepth_(0);
+std::atomic<std::size_t> outSent_(0);
+std::atomic<std::size_t> outLate_(0);
+
+/* reportedLate_, reportedDropped_
+Late and dropped messages already logged. MIDI output thread only. */
+
+std::size_t reportedLate_    = 0;
+std::size_t reportedDropped_ = 0;
+
+/* lastStamp_
+Arrival time of the last MIDI message received. */
+
+std::chrono::steady_clock::time_point lastStamp_ = {};
+
+/* -------------------------------------------------------------------------- */
+
+/* stamp_
+Returns the arrival time of a MIDI message, given RtMidi's delta time 't' (in 
+seconds) from the previous message. Deltas come from the MIDI driver, so they
+keep the original spacing of messages even when delivered in a burst. The sum 
+of deltas is pulled back to the system clock when it ends up in the future or
+drifts too much behind. */
+
+std::chrono::steady_clock::time_point stamp_(double t)
+{
+	const auto now   = std::chrono::steady_clock::now();
+	const auto delta = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+	    std::chrono::duration<double>(t));
+
+	auto stamp = lastStamp_ + delta;
+	if (lastStamp_ == std::chrono::steady_clock::time_point{} || stamp > now ||
+	    now - stamp > std::chrono::milliseconds(G_MIDI_STAMP_MAX_DRIFT))
+		stamp = now;
+
+	lastStamp_ = stamp;
+	return stamp;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void callback_(double t, std::vector<unsigned char>* msg, void* /*data*/)
 {
+	const auto stamp = stamp_(t);
+
+	/* Single-byte system real-time messages: clock and transport from an 
+	external master. */
+
+	if (msg->size() == 1)
+	{
+		clock::recvMidiSync(msg->at(0), stamp);
+		return;
+	}
+
 	if (msg->size() < 3)
 	{
 		//u::log::print("[KM] MIDI received - unknown signal - size=%d, value=0x", (int) msg->size());
@@ -56,7 +151,120 @@ static void callback_(double /*t*/, std::vector<unsigned char>* msg, void* /*dat
 		//u::log::print("\n");
 		return;
 	}
-	midiDispatcher::dispatch(msg->at(0), msg->at(1), msg->at(2));
+	midiDispatcher::dispatch(msg->at(0), msg->at(1), msg->at(2), stamp);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* makeMessage_
+Builds a message out of bytes 'b1', 'b2' and 'b3' (-1 = unused), due at 
+'time'. */
+
+OutMessage_ makeMessage_(int b1, int b2, int b3, std::chrono::steady_clock::time_point time)
+{
+	OutMessage_ m;
+	m.bytes[m.size++] = b1;
+	if (b2 != -1)
+		m.bytes[m.size++] = b2;
+	if (b3 != -1)
+		m.bytes[m.size++] = b3;
+	m.time = time;
+	return m;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* push_
+Queues message 'm' for the MIDI output thread. Lock-free. The thread is not
+woken up: most messages come from the audio thread, so the MIDI output thread
+polls the queue instead, see processOut_(). */
+
+void push_(const OutMessage_& m)
+{
+	if (!status_)
+		return;
+	if (!outQueue_.push(m))
+		return; // Counted by the queue as overflow, see getOutStats()
+	outDepth_.fetch_add(1);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void sendNow_(const OutMessage_& m)
+{
+	outBuffer_.assign(m.bytes.begin(), m.bytes.begin() + m.size);
+	midiOut_->sendMessage(&outBuffer_);
+
+	const auto lateness = std::chrono::steady_clock::now() - m.time;
+	if (lateness > std::chrono::milliseconds(G_MIDI_OUT_LATE_TIME))
+		outLate_.fetch_add(1);
+	outSent_.fetch_add(1);
+	outDepth_.fetch_sub(1);
+
+	u::log::print("[KM::send] send msg=(%X %X %X)\n", m.bytes[0], m.bytes[1], m.bytes[2]);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* checkOutStats_
+Logs messages sent late or dropped since the last check, if any, along with the
+current queue depth. */
+
+void checkOutStats_()
+{
+	const OutStats stats = getOutStats();
+	if (stats.late == reportedLate_ && stats.dropped == reportedDropped_)
+		return;
+	u::log::print("[KM] MIDI output: %zu messages late, %zu dropped (queue full), %zu queued\n",
+	    stats.late - reportedLate_, stats.dropped - reportedDropped_, stats.depth);
+	reportedLate_    = stats.late;
+	reportedDropped_ = stats.dropped;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* processOut_
+Body of the MIDI output thread, run every G_MIDI_OUT_POLL milliseconds. Moves 
+new messages into the pending list, then sends those that are due. Waits for 
+a message due before the next run, so that it goes out on time; leaves the 
+rest to the next run. */
+
+void processOut_()
+{
+	using namespace std::chrono;
+
+	const auto byTime = [](const OutMessage_& a, const OutMessage_& b) { return a.time < b.time; };
+
+	while (true)
+	{
+		/* Insert after messages with the same time, to keep their order. */
+
+		OutMessage_ m;
+		while (outQueue_.pop(m))
+			outPending_.insert(std::upper_bound(outPending_.begin(), outPending_.end(), m, byTime), m);
+
+		if (outPending_.empty())
+		{
+			checkOutStats_();
+			return;
+		}
+
+		const auto now  = steady_clock::now();
+		const auto next = outPending_.front().time;
+
+		if (next <= now)
+		{
+			sendNow_(outPending_.front());
+			outPending_.erase(outPending_.begin());
+		}
+		else if (next - now < milliseconds(G_MIDI_OUT_POLL))
+			std::this_thread::sleep_until(next);
+		else
+		{
+			checkOutStats_();
+			return;
+		}
+	}
 }
 
 /* -------------------------------------------------------------------------- */
@@ -118,6 +326,10 @@ int openOutDevice(int port)
 			midiOut_->openPort(port, getOutPortName(port));
 			u::log::print("[KM] MIDI out port %d open\n", port);
 
+			outPending_.reserve(G_MAX_MIDI_OUT_EVENTS);
+			outWorker_.stop();
+			outWorker_.start(processOut_, G_MIDI_OUT_POLL);
+
 			/* TODO - it shold send midiLightning message only if there is a map loaded
 			and available in midimap:: */
 
@@ -223,33 +435,34 @@ std::string getInPortName(unsigned p)
 
 void send(uint32_t data)
 {
-	if (!status_)
-		return;
+	send(getB1(data), getB2(data), getB3(data));
+}
 
-	std::vector<unsigned char> msg(1, getB1(data));
-	msg.push_back(getB2(data));
-	msg.push_back(getB3(data));
+/* -------------------------------------------------------------------------- */
 
-	midiOut_->sendMessage(&msg);
-	u::log::print("[KM::send] send msg=0x%X (%X %X %X)\n", data, msg[0], msg[1], msg[2]);
+void send(int b1, int b2, int b3)
+{
+	push_(makeMessage_(b1, b2, b3, std::chrono::steady_clock::now()));
 }
 
 /* -------------------------------------------------------------------------- */
 
-void send(int b1, int b2, int b3)
+void sendAt(uint32_t data, Frame delta)
 {
-	if (!status_)
-		return;
+	sendAt(delta, getB1(data), getB2(data), getB3(data));
+}
 
-	std::vector<unsigned char> msg(1, b1);
+void sendAt(Frame delta, int b1, int b2, int b3)
+{
+	const Frame latency = static_cast<Frame>(kernelAudio::getOutputLatency());
+	push_(makeMessage_(b1, b2, b3, mixer::getFrameTime(delta + latency)));
+}
 
-	if (b2 != -1)
-		msg.push_back(b2);
-	if (b3 != -1)
-		msg.push_back(b3);
+/* -------------------------------------------------------------------------- */
 
-	midiOut_->sendMessage(&msg);
-	u::log::print("[KM::send] send msg=(%X %X %X)\n", b1, b2, b3);
+OutStats getOutStats()
+{
+	return {outDepth_.load(), outSent_.load(), outLate_.load(), outQueue_.countOverflows()};
 }
 
 /* -------------------------------------------------------------------------- */
@@ -27,7 +27,9 @@
 #ifndef G_KERNELMIDI_H
 #define G_KERNELMIDI_H
 
+#include "core/types.h"
 #include "midiMapConf.h"
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -43,12 +45,39 @@ int getB3(uint32_t iValue);
 
 uint32_t getIValue(int b1, int b2, int b3);
 
+/* OutStats
+State of the MIDI output queue: messages waiting to be sent, sent so far, sent
+later than scheduled and dropped because the queue was full. */
+
+struct OutStats
+{
+	std::size_t depth   = 0;
+	std::size_t sent    = 0;
+	std::size_t late    = 0;
+	std::size_t dropped = 0;
+};
+
 /* send
-Sends a MIDI message 's' as uint32_t or as separate bytes. */
+Queues a MIDI message 's' as uint32_t or as separate bytes, to be sent as soon
+as possible by the MIDI output thread. Lock-free, never blocks: can be called 
+from any thread. */
 
 void send(uint32_t s);
 void send(int b1, int b2 = -1, int b3 = -1);
 
+/* sendAt
+Like send(), but the message goes out together with frame 'delta' of the audio
+block being rendered, output latency included. Realtime thread only. */
+
+void sendAt(uint32_t s, Frame delta);
+void sendAt(Frame delta, int b1, int b2 = -1, int b3 = -1);
+
+/* getOutStats
+Returns the current state of the MIDI output queue. Late and dropped messages
+are also logged by the MIDI output thread as they happen. */
+
+OutStats getOutStats();
+
 /* sendMidiLightning
 Sends a MIDI lightning message defined by 'msg'. */
 
@@ -37,7 +37,12 @@
 #include "glue/plugin.h"
 #include "utils/log.h"
 #include "utils/math.h"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace giada::m::midiDispatcher
@@ -64,169 +69,318 @@ bool isMasterMidiInAllowed_(int c)
 
 bool isChannelMidiInAllowed_(ID channelId, int c)
 {
-	return model::get().getChannel(channelId).midiLearner.isAllowed(c);
+	return std::as_const(model::get()).getChannel(channelId).midiLearner.isAllowed(c);
 }
 
 /* -------------------------------------------------------------------------- */
 
-#ifdef WITH_VST
+/* Target_
+What a learnt MIDI message is bound to. */
+
+enum class Target_
+{
+	KEY_PRESS,
+	KEY_RELEASE,
+	MUTE,
+	KILL,
+	ARM,
+	SOLO,
+	VOLUME,
+	PITCH,
+	READ_ACTIONS,
+	PLUGIN_PARAM,
+	REWIND,
+	START_STOP,
+	ACTION_REC,
+	INPUT_REC,
+	METRONOME,
+	VOLUME_IN,
+	VOLUME_OUT,
+	BEAT_DOUBLE,
+	BEAT_HALF
+};
+
+/* Binding_
+A single learnt MIDI message, compiled out of the model. 'channelId' is unused
+for master bindings, 'pluginId' and 'paramIndex' are for plug-in parameters
+only. */
+
+struct Binding_
+{
+	Target_     target;
+	ID          channelId  = 0;
+	ID          pluginId   = 0;
+	std::size_t paramIndex = 0;
+};
+
+/* Table_
+Bindings by 'pure' MIDI message (i.e. velocity stripped off). Bindings sharing
+the same message are stored in the order they were evaluated in the model. */
+
+using Table_ = std::unordered_map<uint32_t, std::vector<Binding_>>;
+
+/* masterTable_, channelTable_
+Compiled MIDI-learn bindings, only accessed by the event dispatcher thread. 
+They are rebuilt lazily when the model structure changes (see 
+model::getVersion()) or when a binding is learnt or cleared (tableDirty_). */
 
-void processPlugins_(const std::vector<Plugin*>& plugins, const MidiEvent& midiEvent)
+Table_            masterTable_;
+Table_            channelTable_;
+unsigned long     tableVersion_ = 0;
+std::atomic<bool> tableDirty_   = true;
+
+/* -------------------------------------------------------------------------- */
+
+/* addBinding_
+Adds a binding to table 't', unless 'value' is not learnt yet (0x0). */
+
+void addBinding_(Table_& t, uint32_t value, Binding_ b)
 {
-	uint32_t pure = midiEvent.getRawNoVelocity();
-	float    vf   = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, 1.0f);
+	if (value != 0x0)
+		t[value].push_back(b);
+}
 
-	/* Plugins' parameters layout reflects the structure of the matrix
-	Channel::midiInPlugins. It is safe to assume then that Plugin 'p' and 
-	parameter indexes match both the structure of Channel::midiInPlugins and the 
-	vector of plugins. */
+/* -------------------------------------------------------------------------- */
 
-	for (Plugin* p : plugins)
+void compileChannel_(const channel::Data& c)
+{
+	/* Channel parameters are mutually exclusive: a message bound to more than
+	one of them triggers the first one only, in the following order. */
+
+	const std::pair<uint32_t, Target_> params[] = {
+	    {c.midiLearner.keyPress.getValue(), Target_::KEY_PRESS},
+	    {c.midiLearner.keyRelease.getValue(), Target_::KEY_RELEASE},
+	    {c.midiLearner.mute.getValue(), Target_::MUTE},
+	    {c.midiLearner.kill.getValue(), Target_::KILL},
+	    {c.midiLearner.arm.getValue(), Target_::ARM},
+	    {c.midiLearner.solo.getValue(), Target_::SOLO},
+	    {c.midiLearner.volume.getValue(), Target_::VOLUME},
+	    {c.midiLearner.pitch.getValue(), Target_::PITCH},
+	    {c.midiLearner.readActions.getValue(), Target_::READ_ACTIONS}};
+
+	for (auto it = std::begin(params); it != std::end(params); ++it)
 	{
-		for (const MidiLearnParam& param : p->midiInParams)
-		{
-			if (pure != param.getValue())
-				continue;
-			c::events::setPluginParameter(p->id, param.getIndex(), vf, /*gui=*/false);
-			u::log::print("  >>> [pluginId=%d paramIndex=%d] (pure=0x%X, value=%d, float=%f)\n",
-			    p->id, param.getIndex(), pure, midiEvent.getVelocity(), vf);
-		}
+		auto sameValue = [it](const auto& p) { return p.first == it->first; };
+		if (std::none_of(std::begin(params), it, sameValue))
+			addBinding_(channelTable_, it->first, {it->second, c.id});
 	}
-}
 
+#ifdef WITH_VST
+	for (const Plugin* p : c.plugins)
+		for (const MidiLearnParam& param : p->midiInParams)
+			addBinding_(channelTable_, param.getValue(),
+			    {Target_::PLUGIN_PARAM, c.id, p->id, param.getIndex()});
 #endif
+}
 
 /* -------------------------------------------------------------------------- */
 
-void processChannels_(const MidiEvent& midiEvent)
+void compileMaster_(const model::MidiIn& midiIn)
 {
-	uint32_t pure = midiEvent.getRawNoVelocity();
-
-	for (const channel::Data& c : model::get().channels)
+	/* Same as channel parameters above: first match wins. */
+
+	const std::pair<uint32_t, Target_> params[] = {
+	    {midiIn.rewind, Target_::REWIND},
+	    {midiIn.startStop, Target_::START_STOP},
+	    {midiIn.actionRec, Target_::ACTION_REC},
+	    {midiIn.inputRec, Target_::INPUT_REC},
+	    {midiIn.metronome, Target_::METRONOME},
+	    {midiIn.volumeIn, Target_::VOLUME_IN},
+	    {midiIn.volumeOut, Target_::VOLUME_OUT},
+	    {midiIn.beatDouble, Target_::BEAT_DOUBLE},
+	    {midiIn.beatHalf, Target_::BEAT_HALF}};
+
+	for (auto it = std::begin(params); it != std::end(params); ++it)
 	{
+		auto sameValue = [it](const auto& p) { return p.first == it->first; };
+		if (std::none_of(std::begin(params), it, sameValue))
+			addBinding_(masterTable_, it->first, {it->second});
+	}
+}
 
-		/* Do nothing on this channel if MIDI in is disabled or filtered out for
-		the current MIDI channel. */
-		if (!c.midiLearner.isAllowed(midiEvent.getChannel()))
-			continue;
+/* -------------------------------------------------------------------------- */
 
-		if (pure == c.midiLearner.keyPress.getValue())
-		{
-			u::log::print("  >>> keyPress, ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::pressChannel(c.id, midiEvent.getVelocity(), Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.keyRelease.getValue())
-		{
-			u::log::print("  >>> keyRel ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::releaseChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.mute.getValue())
-		{
-			u::log::print("  >>> mute ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::toggleMuteChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.kill.getValue())
-		{
-			u::log::print("  >>> kill ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::killChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.arm.getValue())
-		{
-			u::log::print("  >>> arm ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::toggleArmChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.solo.getValue())
-		{
-			u::log::print("  >>> solo ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::toggleSoloChannel(c.id, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.volume.getValue())
-		{
-			float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME);
-			u::log::print("  >>> volume ch=%d (pure=0x%X, value=%d, float=%f)\n",
-			    c.id, pure, midiEvent.getVelocity(), vf);
-			c::events::setChannelVolume(c.id, vf, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.pitch.getValue())
-		{
-			float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_PITCH);
-			u::log::print("  >>> pitch ch=%d (pure=0x%X, value=%d, float=%f)\n",
-			    c.id, pure, midiEvent.getVelocity(), vf);
-			c::events::setChannelPitch(c.id, vf, Thread::MIDI);
-		}
-		else if (pure == c.midiLearner.readActions.getValue())
-		{
-			u::log::print("  >>> toggle read actions ch=%d (pure=0x%X)\n", c.id, pure);
-			c::events::toggleReadActionsChannel(c.id, Thread::MIDI);
-		}
+/* compile_
+Rebuilds the binding tables if the model has changed since the last time. */
 
-#ifdef WITH_VST
-		/* Process learned plugins parameters. */
-		processPlugins_(c.plugins, midiEvent);
-#endif
+void compile_()
+{
+	const unsigned long version = model::getVersion();
 
-		/* Redirect raw MIDI message (pure + velocity) to plug-ins in armed
-		channels. */
-		if (c.armed)
-			c::events::sendMidiToChannel(c.id, midiEvent, Thread::MIDI);
-	}
+	if (!tableDirty_.exchange(false) && version == tableVersion_)
+		return;
+
+	masterTable_.clear();
+	channelTable_.clear();
+
+	compileMaster_(model::get().midiIn);
+	for (const channel::Data& c : std::as_const(model::get().channels))
+		compileChannel_(c);
+
+	tableVersion_ = version;
+
+	u::log::print("[midiDispatcher] MIDI bindings compiled - master=%zu, channels=%zu\n",
+	    masterTable_.size(), channelTable_.size());
 }
 
 /* -------------------------------------------------------------------------- */
 
-void processMaster_(const MidiEvent& midiEvent)
+const std::vector<Binding_>* lookup_(const Table_& t, uint32_t pure)
 {
-	const uint32_t       pure   = midiEvent.getRawNoVelocity();
-	const model::MidiIn& midiIn = model::get().midiIn;
+	const auto it = t.find(pure);
+	return it == t.end() ? nullptr : &it->second;
+}
 
-	if (pure == midiIn.rewind)
-	{
-		c::events::rewindSequencer(Thread::MIDI);
-		u::log::print("  >>> rewind (master) (pure=0x%X)\n", pure);
-	}
-	else if (pure == midiIn.startStop)
-	{
-		c::events::toggleSequencer(Thread::MIDI);
-		u::log::print("  >>> startStop (master) (pure=0x%X)\n", pure);
-	}
-	else if (pure == midiIn.actionRec)
-	{
-		c::events::toggleActionRecording();
-		u::log::print("  >>> actionRec (master) (pure=0x%X)\n", pure);
-	}
-	else if (pure == midiIn.inputRec)
-	{
-		c::events::toggleInputRecording();
-		u::log::print("  >>> inputRec (master) (pure=0x%X)\n", pure);
-	}
-	else if (pure == midiIn.metronome)
+/* -------------------------------------------------------------------------- */
+
+void processChannel_(const Binding_& b, const MidiEvent& midiEvent)
+{
+	const uint32_t       pure = midiEvent.getRawNoVelocity();
+	const channel::Data* c    = std::as_const(model::get()).findChannel(b.channelId);
+
+	/* Do nothing on this channel if MIDI in is disabled or filtered out for
+	the current MIDI channel. */
+	if (c == nullptr || !c->midiLearner.isAllowed(midiEvent.getChannel()))
+		return;
+
+	switch (b.target)
 	{
-		c::events::toggleMetronome();
-		u::log::print("  >>> metronome (master) (pure=0x%X)\n", pure);
-	}
-	else if (pure == midiIn.volumeIn)
+	case Target_::KEY_PRESS:
+		u::log::print("  >>> keyPress, ch=%d (pure=0x%X)\n", c->id, pure);
+		c::events::pressChannel(c->id, midiEvent.getVelocity(), Thread::MIDI);
+		break;
+	case Target_::KEY_RELEASE:
+		u::log::print("  >>> keyRel ch=%d (pure=0x%X)\n", c->id, pure);
+		c::events::releaseChannel(c->id, Thread::MIDI);
+		break;
+	case Target_::MUTE:
+		u::log::print("  >>> mute ch=%d (pure=0x%X)\n", c->id, pure);
+		c::events::toggleMuteChannel(c->id, Thread::MIDI);
+		break;
+	case Target_::KILL:
+		u::log::print("  >>> kill ch=%d (pure=0x%X)\n", c->id, pure);
+		c::events::killChannel(c->id, Thread::MIDI);
+		break;
+	case Target_::ARM:
+		u::log::print("  >>> arm ch=%d (pure=0x%X)\n", c->id, pure);
+		c::events::toggleArmChannel(c->id, Thread::MIDI);
+		break;
+	case Target_::SOLO:
+		u::log::print("  >>> solo ch=%d (pure=0x%X)\n", c->id, pure);
+		c::events::toggleSoloChannel(c->id, Thread::MIDI);
+		break;
+	case Target_::VOLUME:
 	{
 		float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME);
-		c::events::setMasterInVolume(vf, Thread::MIDI);
-		u::log::print("  >>> input volume (master) (pure=0x%X, value=%d, float=%f)\n",
-		    pure, midiEvent.getVelocity(), vf);
+		u::log::print("  >>> volume ch=%d (pure=0x%X, value=%d, float=%f)\n",
+		    c->id, pure, midiEvent.getVelocity(), vf);
+		c::events::setChannelVolume(c->id, vf, Thread::MIDI);
+		break;
 	}
-	else if (pure == midiIn.volumeOut)
+	case Target_::PITCH:
 	{
-		float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME);
-		c::events::setMasterOutVolume(vf, Thread::MIDI);
-		u::log::print("  >>> output volume (master) (pure=0x%X, value=%d, float=%f)\n",
-		    pure, midiEvent.getVelocity(), vf);
+		float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_PITCH);
+		u::log::print("  >>> pitch ch=%d (pure=0x%X, value=%d, float=%f)\n",
+		    c->id, pure, midiEvent.getVelocity(), vf);
+		c::events::setChannelPitch(c->id, vf, Thread::MIDI);
+		break;
 	}
-	else if (pure == midiIn.beatDouble)
+	case Target_::READ_ACTIONS:
+		u::log::print("  >>> toggle read actions ch=%d (pure=0x%X)\n", c->id, pure);
+		c::events::toggleReadActionsChannel(c->id, Thread::MIDI);
+		break;
+#ifdef WITH_VST
+	case Target_::PLUGIN_PARAM:
 	{
-		c::events::multiplyBeats();
-		u::log::print("  >>> sequencer x2 (master) (pure=0x%X)\n", pure);
+		float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, 1.0f);
+		c::events::setPluginParameter(b.pluginId, b.paramIndex, vf, /*gui=*/false);
+		u::log::print("  >>> [pluginId=%d paramIndex=%zu] (pure=0x%X, value=%d, float=%f)\n",
+		    b.pluginId, b.paramIndex, pure, midiEvent.getVelocity(), vf);
+		break;
 	}
-	else if (pure == midiIn.beatHalf)
+#endif
+	default:
+		assert(false);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void processChannels_(const MidiEvent& midiEvent)
+{
+	if (const std::vector<Binding_>* bindings = lookup_(channelTable_, midiEvent.getRawNoVelocity()))
+		for (const Binding_& b : *bindings)
+			processChannel_(b, midiEvent);
+
+	/* Redirect raw MIDI message (pure + velocity) to plug-ins in armed
+	channels. */
+
+	for (const channel::Data& c : std::as_const(model::get().channels))
+		if (c.armed && c.midiLearner.isAllowed(midiEvent.getChannel()))
+			c::events::sendMidiToChannel(c.id, midiEvent, Thread::MIDI);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void processMaster_(const MidiEvent& midiEvent)
+{
+	const uint32_t               pure     = midiEvent.getRawNoVelocity();
+	const std::vector<Binding_>* bindings = lookup_(masterTable_, pure);
+
+	if (bindings == nullptr)
+		return;
+
+	for (const Binding_& b : *bindings)
 	{
-		c::events::divideBeats();
-		u::log::print("  >>> sequencer /2 (master) (pure=0x%X)\n", pure);
+		switch (b.target)
+		{
+		case Target_::REWIND:
+			c::events::rewindSequencer(Thread::MIDI);
+			u::log::print("  >>> rewind (master) (pure=0x%X)\n", pure);
+			break;
+		case Target_::START_STOP:
+			c::events::toggleSequencer(Thread::MIDI);
+			u::log::print("  >>> startStop (master) (pure=0x%X)\n", pure);
+			break;
+		case Target_::ACTION_REC:
+			c::events::toggleActionRecording();
+			u::log::print("  >>> actionRec (master) (pure=0x%X)\n", pure);
+			break;
+		case Target_::INPUT_REC:
+			c::events::toggleInputRecording();
+			u::log::print("  >>> inputRec (master) (pure=0x%X)\n", pure);
+			break;
+		case Target_::METRONOME:
+			c::events::toggleMetronome();
+			u::log::print("  >>> metronome (master) (pure=0x%X)\n", pure);
+			break;
+		case Target_::VOLUME_IN:
+		{
+			float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME);
+			c::events::setMasterInVolume(vf, Thread::MIDI);
+			u::log::print("  >>> input volume (master) (pure=0x%X, value=%d, float=%f)\n",
+			    pure, midiEvent.getVelocity(), vf);
+			break;
+		}
+		case Target_::VOLUME_OUT:
+		{
+			float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME);
+			c::events::setMasterOutVolume(vf, Thread::MIDI);
+			u::log::print("  >>> output volume (master) (pure=0x%X, value=%d, float=%f)\n",
+			    pure, midiEvent.getVelocity(), vf);
+			break;
+		}
+		case Target_::BEAT_DOUBLE:
+			c::events::multiplyBeats();
+			u::log::print("  >>> sequencer x2 (master) (pure=0x%X)\n", pure);
+			break;
+		case Target_::BEAT_HALF:
+			c::events::divideBeats();
+			u::log::print("  >>> sequencer /2 (master) (pure=0x%X)\n", pure);
+			break;
+		default:
+			assert(false);
+		}
 	}
 }
 
@@ -282,6 +436,7 @@ void learnChannel_(MidiEvent e, int param, ID channelId, std::function<void()> d
 	}
 
 	model::swap(model::SwapType::SOFT);
+	tableDirty_.store(true);
 
 	stopLearn();
 	doneCb();
@@ -326,6 +481,7 @@ void learnMaster_(MidiEvent e, int param, std::function<void()> doneCb)
 	}
 
 	model::swap(model::SwapType::SOFT);
+	tableDirty_.store(true);
 
 	stopLearn();
 	doneCb();
@@ -412,7 +568,7 @@ void clearPluginLearn(std::size_t paramIndex, ID pluginId, std::function<void()>
 
 /* -------------------------------------------------------------------------- */
 
-void dispatch(int byte1, int byte2, int byte3)
+void dispatch(int byte1, int byte2, int byte3, std::chrono::steady_clock::time_point t)
 {
 	/* Here we want to catch two things: a) note on/note off from a keyboard and 
 	b) knob/wheel/slider movements from a controller. 
@@ -431,15 +587,20 @@ void dispatch(int byte1, int byte2, int byte3)
 	then each channel in the stack. This way incoming signals don't get processed 
 	by glue_* when MIDI learning is on. */
 
-	eventDispatcher::pumpEvent({eventDispatcher::EventType::FUNCTION, 0, 0, [midiEvent]() {
+	eventDispatcher::pumpEvent({eventDispatcher::EventType::FUNCTION, 0, 0, [midiEvent, t]() {
 		                            if (learnCb_ != nullptr)
 		                            {
 			                            learnCb_(midiEvent);
 		                            }
 		                            else
 		                            {
+			                            /* Events generated here carry the
+			                            message arrival time. */
+			                            eventDispatcher::setMidiTime(t);
+			                            compile_();
 			                            processMaster_(midiEvent);
 			                            processChannels_(midiEvent);
+			                            eventDispatcher::setMidiTime({});
 			                            triggerSignalCb_();
 		                            }
 	                            }});
@@ -30,6 +30,7 @@
 #include "core/midiEvent.h"
 #include "core/model/model.h"
 #include "core/types.h"
+#include <chrono>
 #include <cstdint>
 #include <functional>
 
@@ -45,7 +46,10 @@ void startPluginLearn(std::size_t paramIndex, ID pluginId, std::function<void()>
 void clearPluginLearn(std::size_t paramIndex, ID pluginId, std::function<void()> f);
 #endif
 
-void dispatch(int byte1, int byte2, int byte3);
+/* dispatch
+Processes an incoming MIDI message, received at time 't'. */
+
+void dispatch(int byte1, int byte2, int byte3, std::chrono::steady_clock::time_point t);
 
 void setSignalCallback(std::function<void()> f);
 } // namespace giada::m::midiDispatcher
@@ -0,0 +1,221 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/midiSync.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace giada::m
+{
+namespace
+{
+constexpr int64_t TICKS_PER_BEAT    = 24;
+constexpr int64_t QUARTER_FRAMES    = 4; // Per timecode frame
+constexpr int64_t QUARTER_FRAME_SET = 8; // Quarter frames for a full timecode
+
+/* -------------------------------------------------------------------------- */
+
+/* ceilDiv_
+Integer division of positive values, rounded up. */
+
+int64_t ceilDiv_(int64_t a, int64_t b)
+{
+	return (a + b - 1) / b;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* getRateCode_
+Returns the MTC frame rate code, sent along with the hours. */
+
+int getRateCode_(float fps)
+{
+	if (fps < 24.5f)
+		return 0; // 24 fps
+	if (fps < 27.5f)
+		return 1; // 25 fps
+	if (fps < 29.985f)
+		return 2; // 29.97 fps (drop frame)
+	return 3;     // 30 fps
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+MidiSync::MidiSync()
+: m_sampleRate(G_DEFAULT_SAMPLERATE)
+, m_fps(25.0f)
+, m_mtcPosition(0)
+, m_rewind(false)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiSync::setup(int sampleRate, float fps)
+{
+	assert(sampleRate > 0);
+	assert(fps > 0.0f);
+
+	m_sampleRate  = sampleRate;
+	m_fps         = fps;
+	m_mtcPosition = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiSync::rewind()
+{
+	m_rewind.store(true);
+}
+
+/* -------------------------------------------------------------------------- */
+
+const MidiSync::Messages& MidiSync::advance(int mode, Frame currentFrame,
+    Frame bufferSize, Frame framesInLoop, Frame framesInBeat)
+{
+	m_messages.clear();
+
+	if (m_rewind.exchange(false))
+		m_mtcPosition = 0;
+
+	if (mode == MIDI_SYNC_CLOCK_M && framesInLoop > 0 && framesInBeat > 0)
+	{
+		/* Split the block in two ranges if it crosses the loop boundary, as
+		the sequencer does. */
+
+		Frame global = currentFrame % framesInLoop;
+		Frame local  = 0;
+		while (local < bufferSize)
+		{
+			const Frame count = std::min(bufferSize - local, framesInLoop - global);
+			advanceClock(global, global + count, local, framesInBeat);
+			local += count;
+			global = 0;
+		}
+	}
+	else if (mode == MIDI_SYNC_MTC_M)
+		advanceMtc(bufferSize);
+
+	return m_messages;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiSync::advanceClock(Frame from, Frame to, Frame local, Frame framesInBeat)
+{
+	/* The k-th tick of the loop falls on frame ceil(k * framesInBeat / 24), 
+	computed in integers: no error piles up, the tick on each beat lands on 
+	the beat itself. */
+
+	for (int64_t k = (static_cast<int64_t>(from) * TICKS_PER_BEAT) / framesInBeat;; k++)
+	{
+		const int64_t frame = ceilDiv_(k * framesInBeat, TICKS_PER_BEAT);
+		if (frame < from)
+			continue;
+		if (frame >= to)
+			break;
+		m_messages.push_back({MIDI_CLOCK, -1, local + static_cast<Frame>(frame - from)});
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiSync::advanceMtc(Frame bufferSize)
+{
+	/* The q-th quarter frame falls on frame ceil(q * sampleRate / (4 * fps)),
+	counting from the last rewind. Computed in integers, with fps in 
+	thousandths to support fractional rates. */
+
+	const int64_t num  = static_cast<int64_t>(m_sampleRate) * 1000;
+	const int64_t den  = QUARTER_FRAMES * std::llround(m_fps * 1000);
+	const int64_t from = m_mtcPosition;
+	const int64_t to   = m_mtcPosition + bufferSize;
+
+	for (int64_t q = (from * den) / num;; q++)
+	{
+		const int64_t frame = ceilDiv_(q * num, den);
+		if (frame < from)
+			continue;
+		if (frame >= to)
+			break;
+		m_messages.push_back({MIDI_MTC_QUARTER, quarterFrame(q), static_cast<Frame>(frame - from)});
+	}
+
+	m_mtcPosition = to;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int MidiSync::quarterFrame(int64_t q) const
+{
+	/* A full set of 8 quarter frames spans two timecode frames and carries the
+	time of its first one. Drop frame counting is not supported: 29.97 fps is
+	counted as 30. */
+
+	const int64_t fps     = static_cast<int64_t>(std::lround(m_fps));
+	const int64_t piece   = q % QUARTER_FRAME_SET;
+	const int64_t total   = (q / QUARTER_FRAME_SET) * (QUARTER_FRAME_SET / QUARTER_FRAMES);
+	const int     frames  = static_cast<int>(total % fps);
+	const int     seconds = static_cast<int>((total / fps) % 60);
+	const int     minutes = static_cast<int>((total / (fps * 60)) % 60);
+	const int     hours   = static_cast<int>((total / (fps * 3600)) % 24);
+
+	int nibble = 0;
+	switch (piece)
+	{
+	case 0:
+		nibble = frames & 0x0F;
+		break;
+	case 1:
+		nibble = frames >> 4;
+		break;
+	case 2:
+		nibble = seconds & 0x0F;
+		break;
+	case 3:
+		nibble = seconds >> 4;
+		break;
+	case 4:
+		nibble = minutes & 0x0F;
+		break;
+	case 5:
+		nibble = minutes >> 4;
+		break;
+	case 6:
+		nibble = hours & 0x0F;
+		break;
+	case 7:
+		nibble = (hours >> 4) | (getRateCode_(m_fps) << 1);
+		break;
+	}
+
+	return static_cast<int>(piece << 4) | nibble;
+}
+} // namespace giada::m
@@ -0,0 +1,97 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_MIDI_SYNC_H
+#define G_MIDI_SYNC_H
+
+#include "core/const.h"
+#include "core/ringBuffer.h"
+#include "core/types.h"
+#include <atomic>
+#include <cstdint>
+
+namespace giada::m
+{
+/* MidiSync
+Generates MIDI clock and MIDI timecode (MTC) messages for each audio block, at
+the exact frame they fall on. MIDI clock ticks (24 per beat) are locked to the
+beat grid of the loop, so they follow tempo changes and rewinds; MTC quarter 
+frames (4 per timecode frame) follow the time elapsed since the last rewind. */
+
+class MidiSync
+{
+public:
+	/* Message
+	A MIDI sync message at frame 'delta' of the block. Unused bytes are -1. */
+
+	struct Message
+	{
+		int   b1    = -1;
+		int   b2    = -1;
+		Frame delta = 0;
+	};
+
+	using Messages = RingBuffer<Message, G_MAX_SYNC_MESSAGES>;
+
+	MidiSync();
+
+	/* setup
+	Sets sample rate and MTC frames per second. Not realtime-safe. */
+
+	void setup(int sampleRate, float fps);
+
+	/* rewind
+	Brings the MTC position back to zero, starting from the next block. Can be
+	called from any thread. */
+
+	void rewind();
+
+	/* advance
+	Returns the messages for the block of 'bufferSize' frames starting at frame
+	'currentFrame' of the loop. 'mode' is one of the MIDI_SYNC_* values: only
+	masters (MIDI_SYNC_CLOCK_M, MIDI_SYNC_MTC_M) generate anything. */
+
+	const Messages& advance(int mode, Frame currentFrame, Frame bufferSize,
+	    Frame framesInLoop, Frame framesInBeat);
+
+private:
+	void advanceClock(Frame from, Frame to, Frame local, Frame framesInBeat);
+	void advanceMtc(Frame bufferSize);
+
+	/* quarterFrame
+	Returns the data byte of the q-th MTC quarter frame since rewind. */
+
+	int quarterFrame(int64_t q) const;
+
+	Messages          m_messages;
+	int               m_sampleRate;
+	float             m_fps;
+	int64_t           m_mtcPosition; // Frames elapsed since rewind
+	std::atomic<bool> m_rewind;
+};
+} // namespace giada::m
+
+#endif
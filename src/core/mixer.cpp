@@ -26,11 +26,16 @@
 
 #include "core/mixer.h"
 #include "core/audioBuffer.h"
+#include "core/blockClock.h"
 #include "core/const.h"
+#include "core/eventDispatcher.h"
 #include "core/model/model.h"
+#include "core/renderPool.h"
 #include "core/sequencer.h"
+#include "core/simd.h"
 #include "utils/log.h"
 #include "utils/math.h"
+#include <algorithm>
 
 namespace giada::m::mixer
 {
@@ -62,6 +67,25 @@ reached.*/
 
 std::function<void()> endOfRecCb_ = nullptr;
 
+/* renderPool_
+Threads that render channels in parallel. */
+
+RenderPool renderPool_;
+
+/* blockClock_
+Correlates timestamps of live events with the audio stream. */
+
+BlockClock blockClock_;
+
+/* renderLayout_, renderIn_, renderPluginSleepFrames_, renderFrame_
+Data the render pool works on during the current block. Set by the audio thread
+right before running the pool. */
+
+const model::Layout* renderLayout_            = nullptr;
+AudioBuffer*         renderIn_                = nullptr;
+Frame                renderPluginSleepFrames_ = 0;
+Frame                renderFrame_             = -1;
+
 /* -------------------------------------------------------------------------- */
 
 /* fireSignalCb_
@@ -146,11 +170,70 @@ void processLineIn_(const model::Mixer& mixer, const AudioBuffer& inBuf,
 
 /* -------------------------------------------------------------------------- */
 
-void processChannels_(const model::Layout& layout, AudioBuffer& out, AudioBuffer& in)
+/* processLiveEvents_
+Applies live events forwarded to the audio thread by the event dispatcher, at 
+their frame within the current block. The frame is derived from the time the 
+event has been received (e.g. the MIDI message timestamp), relative to the 
+previous block. */
+
+void processLiveEvents_(const model::Layout& layout, Frame bufferSize)
+{
+	eventDispatcher::Event e;
+	while (eventDispatcher::RTevents.pop(e))
+	{
+		const channel::Data* ch = layout.findChannel(e.channelId);
+		if (ch == nullptr) // Channel gone in the meantime
+			continue;
+		e.delta = std::clamp(blockClock_.getOffset(e.pushTime), 0, bufferSize - 1);
+		channel::reactRt(*ch, e);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* renderChannelJob_
+Job executed by the render pool on the i-th channel of the current layout. */
+
+void renderChannelJob_(std::size_t i)
+{
+	const channel::Data& c = renderLayout_->channels[i];
+	if (!c.isInternal())
+		channel::renderBuffer(c, *renderIn_, renderPluginSleepFrames_, renderFrame_);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void processChannels_(const model::Layout& layout, AudioBuffer& out, AudioBuffer& in,
+    Frame pluginSleepFrames, Frame frame)
 {
+	/* Render each channel into its own buffer first, in parallel if the pool
+	has helper threads. Then sum them into the output buffer serially, in layout
+	order: the result is bit-exact regardless of the number of threads. */
+
+	renderLayout_            = &layout;
+	renderIn_                = &in;
+	renderPluginSleepFrames_ = pluginSleepFrames;
+	renderFrame_             = frame;
+	renderPool_.run(layout.channels.size());
+
+	int skippedChannels = 0;
+	int sleepingPlugins = 0;
+
 	for (const channel::Data& c : layout.channels)
-		if (!c.isInternal())
-			channel::render(c, &out, &in, isChannelAudible(c));
+	{
+		if (c.isInternal())
+			continue;
+		channel::sumBuffer(c, out, !layout.mixer.hasSolos || c.solo); // Mute is up to the channel
+		if (c.buffer->silent)
+			skippedChannels++;
+#ifdef WITH_VST
+		if (c.buffer->pluginsAsleep)
+			sleepingPlugins += c.plugins.size();
+#endif
+	}
+
+	layout.mixer.state->skippedChannels.store(skippedChannels);
+	layout.mixer.state->sleepingPlugins.store(sleepingPlugins);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -161,7 +244,7 @@ void processSequencer_(const model::Layout& layout, AudioBuffer& out, const Audi
 	generating metronome audio). This way the metronome is aligned with 
 	everything else. */
 
-	const sequencer::EventBuffer& events = sequencer::advance(in.countFrames());
+	const sequencer::EventBuffer& events = sequencer::advance(in.countFrames(), !layout.locked);
 	sequencer::render(out);
 
 	/* No channel processing if layout is locked: another thread is changing
@@ -194,34 +277,34 @@ void renderPreview_(const model::Layout& layout, AudioBuffer& out)
 
 /* -------------------------------------------------------------------------- */
 
-/* limit_
-Applies a very dumb hard limiter. */
-
-void limit_(AudioBuffer& outBuf)
-{
-	for (int i = 0; i < outBuf.countFrames(); i++)
-		for (int j = 0; j < outBuf.countChannels(); j++)
-			outBuf[i][j] = std::max(-1.0f, std::min(outBuf[i][j], 1.0f));
-}
-
-/* -------------------------------------------------------------------------- */
-
 /* finalizeOutput
 Last touches after the output has been rendered: apply inToOut if any, apply
-output volume, compute peak. */
+output volume, apply a very dumb hard limiter, compute peak. All in a single 
+pass over the output buffer. */
 
 void finalizeOutput_(const model::Mixer& mixer, AudioBuffer& outBuf,
     const RenderInfo& info)
 {
-	if (info.inToOut)
-		outBuf.sum(inBuffer_, info.outVol);
-	else
-		outBuf.applyGain(info.outVol);
+	/* The input buffer is sized after the expected block size, but the audio
+	API might deliver a larger block: only the part of the output covered by 
+	the input gets the input summed in. The rest gets the same treatment minus
+	the input, i.e. it's left unscaled (gain 1.0), just limited and measured. */
+
+	const int          samples = outBuf.countSamples();
+	const int          shared  = info.inToOut ? std::min(samples, inBuffer_.countSamples()) : 0;
+	const simd::Levels head    = simd::get().finalize(outBuf[0], shared > 0 ? inBuffer_[0] : nullptr,
+	    shared > 0 ? shared : samples, info.outVol, info.limitOutput);
 
-	if (info.limitOutput)
-		limit_(outBuf);
+	float peak = head.peak;
 
-	mixer.state->peakOut.store(outBuf.getPeak());
+	if (shared > 0 && shared < samples)
+	{
+		const simd::Levels tail = simd::get().finalize(outBuf[0] + shared, nullptr,
+		    samples - shared, /*gain=*/1.0f, info.limitOutput);
+		peak = std::max(peak, tail.peak);
+	}
+
+	mixer.state->peakOut.store(peak);
 }
 } // namespace
 
@@ -229,7 +312,7 @@ void finalizeOutput_(const model::Mixer& mixer, AudioBuffer& outBuf,
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-void init(Frame maxFramesInLoop, Frame framesInBuffer)
+void init(Frame maxFramesInLoop, Frame framesInBuffer, int sampleRate, int renderThreads)
 {
 	/* Allocate working buffers. recBuffer_ has variable size: it depends on how
 	many frames there are in the current loop. */
@@ -237,8 +320,12 @@ void init(Frame maxFramesInLoop, Frame framesInBuffer)
 	recBuffer_.alloc(maxFramesInLoop, G_MAX_IO_CHANS);
 	inBuffer_.alloc(framesInBuffer, G_MAX_IO_CHANS);
 
-	u::log::print("[mixer::init] buffers ready - maxFramesInLoop=%d, framesInBuffer=%d\n",
-	    maxFramesInLoop, framesInBuffer);
+	simd::init();
+	renderPool_.start(renderThreads, renderChannelJob_, G_AUDIO_THREAD_PRIORITY);
+	blockClock_.reset(sampleRate);
+
+	u::log::print("[mixer::init] buffers ready - maxFramesInLoop=%d, framesInBuffer=%d, renderThreads=%d\n",
+	    maxFramesInLoop, framesInBuffer, renderPool_.countThreads());
 }
 
 /* -------------------------------------------------------------------------- */
@@ -278,6 +365,7 @@ const AudioBuffer& getRecBuffer()
 
 int render(AudioBuffer& out, const AudioBuffer& in, const RenderInfo& info)
 {
+	const auto          now    = std::chrono::steady_clock::now();
 	const model::Lock   rtLock = model::get_RT();
 	const model::Mixer& mixer  = rtLock.get().mixer;
 
@@ -296,6 +384,19 @@ int render(AudioBuffer& out, const AudioBuffer& in, const RenderInfo& info)
 		renderMasterIn_(rtLock.get(), inBuffer_);
 	}
 
+	/* Apply live events before anything else, so that channels render them in 
+	this very block. Not when the layout is locked: channels might be going 
+	away. Events will wait in the queue until the next block. */
+
+	if (!rtLock.get().locked)
+		processLiveEvents_(rtLock.get(), out.countFrames());
+
+	/* Only now move the block clock forward: live events above have been placed
+	relative to the previous block. The sequencer hasn't advanced yet, so 
+	'currentFrame' is where this block starts from. */
+
+	blockClock_.tick(now, out.countFrames(), info.currentFrame);
+
 	/* Record input audio and advance the sequencer only if clock is active:
 	can't record stuff with the sequencer off. */
 
@@ -308,10 +409,14 @@ int render(AudioBuffer& out, const AudioBuffer& in, const RenderInfo& info)
 	}
 
 	/* Channel processing. Don't do it if layout is locked: another thread is 
-	changing data (e.g. Plugins or Waves). */
+	changing data (e.g. Plugins or Waves). Channels render recorded envelopes
+	from the frame this block started from, if the sequencer is running. */
 
 	if (!rtLock.get().locked)
-		processChannels_(rtLock.get(), out, inBuffer_);
+	{
+		const Frame frame = info.isClockActive && info.isClockRunning ? info.currentFrame : -1;
+		processChannels_(rtLock.get(), out, inBuffer_, info.pluginSleepFrames, frame);
+	}
 
 	/* Render remaining internal channels. */
 
@@ -327,6 +432,23 @@ int render(AudioBuffer& out, const AudioBuffer& in, const RenderInfo& info)
 
 /* -------------------------------------------------------------------------- */
 
+Frame getBlockOffset(std::chrono::steady_clock::time_point t)
+{
+	return blockClock_.getOffset(t);
+}
+
+std::chrono::steady_clock::time_point getFrameTime(Frame offset)
+{
+	return blockClock_.getTime(offset);
+}
+
+Frame getBlockPosition(std::chrono::steady_clock::time_point t)
+{
+	return blockClock_.getPosition(t);
+}
+
+/* -------------------------------------------------------------------------- */
+
 void startInputRec(Frame from)
 {
 	inputTracker_ = from;
@@ -350,7 +472,7 @@ bool isChannelAudible(const channel::Data& c)
 {
 	if (c.isInternal())
 		return true;
-	if (c.mute)
+	if (c.state->mute.load())
 		return false;
 	bool hasSolos = model::get().mixer.hasSolos;
 	return !hasSolos || (hasSolos && c.solo);
@@ -363,6 +485,11 @@ float getPeakIn() { return m::model::get().mixer.state->peakIn.load(); }
 
 /* -------------------------------------------------------------------------- */
 
+int getSkippedChannels() { return m::model::get().mixer.state->skippedChannels.load(); }
+int getSleepingPlugins() { return m::model::get().mixer.state->sleepingPlugins.load(); }
+
+/* -------------------------------------------------------------------------- */
+
 RecordInfo getRecordInfo()
 {
 	return {inputTracker_, recBuffer_.countFrames()};
@@ -33,6 +33,7 @@
 #include "core/ringBuffer.h"
 #include "core/types.h"
 #include "deps/rtaudio/RtAudio.h"
+#include <chrono>
 #include <functional>
 
 namespace giada::m
@@ -63,6 +64,8 @@ struct RenderInfo
 	bool  limitOutput;
 	bool  inToOut;
 	Frame maxFramesToRec;
+	Frame pluginSleepFrames;
+	Frame currentFrame;
 	float outVol;
 	float inVol;
 	float recTriggerLevel;
@@ -77,7 +80,12 @@ struct RecordInfo
 	Frame maxLength;
 };
 
-void init(Frame framesInLoop, Frame framesInBuffer);
+/* init
+Allocates working buffers and starts the render pool. 'renderThreads' is the 
+number of threads (audio thread included) used to render channels: 1 means 
+serial rendering on the audio thread only. */
+
+void init(Frame framesInLoop, Frame framesInBuffer, int sampleRate, int renderThreads);
 
 /* enable, disable
 Toggles master callback processing. Useful to suspend the rendering. */
@@ -106,6 +114,24 @@ Core rendering function. */
 
 int render(AudioBuffer& out, const AudioBuffer& in, const RenderInfo& info);
 
+/* getBlockOffset
+Returns the frame offset within the next audio block of an event received at
+time 't', using a clock correlated with the audio stream. See BlockClock. */
+
+Frame getBlockOffset(std::chrono::steady_clock::time_point t);
+
+/* getFrameTime
+Returns the time of frame 'offset' of the audio block being rendered. Offsets
+past the end of the block are fine, e.g. to add the stream latency. */
+
+std::chrono::steady_clock::time_point getFrameTime(Frame offset);
+
+/* getBlockPosition
+Returns the sequencer frame being rendered at time 't', not wrapped around the
+loop length. See BlockClock::getPosition. */
+
+Frame getBlockPosition(std::chrono::steady_clock::time_point t);
+
 /* startInputRec, stopInputRec
 Starts/stops input recording on frame 'from'. The latter returns the number of
 recorded frames. */
@@ -134,6 +160,13 @@ bool isChannelAudible(const channel::Data& c);
 float getPeakOut();
 float getPeakIn();
 
+/* getSkippedChannels, getSleepingPlugins
+Return how many channels were silent (thus not rendered nor summed) and how 
+many plug-ins were asleep during the last block. */
+
+int getSkippedChannels();
+int getSleepingPlugins();
+
 RecordInfo getRecordInfo();
 } // namespace giada::m::mixer
 
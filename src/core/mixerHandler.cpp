@@ -42,6 +42,7 @@
 #include "core/recManager.h"
 #include "core/recorder.h"
 #include "core/recorderHandler.h"
+#include "core/resamplerPool.h"
 #include "core/wave.h"
 #include "core/waveFx.h"
 #include "core/waveManager.h"
@@ -53,6 +54,7 @@
 #include "utils/vector.h"
 #include <algorithm>
 #include <cassert>
+#include <utility>
 #include <vector>
 
 namespace giada::m::mh
@@ -79,7 +81,8 @@ waveManager::Result createWave_(const std::string& fname)
 
 bool anyChannel_(std::function<bool(const channel::Data&)> f)
 {
-	return std::any_of(model::get().channels.begin(), model::get().channels.end(), f);
+	const auto& channels = std::as_const(model::get().channels);
+	return std::any_of(channels.begin(), channels.end(), f);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -171,7 +174,8 @@ void overdubChannel_(channel::Data& ch)
 
 void init()
 {
-	mixer::init(clock::getMaxFramesInLoop(), kernelAudio::getRealBufSize());
+	mixer::init(clock::getMaxFramesInLoop(), kernelAudio::getRealBufSize(), conf::conf.samplerate,
+	    conf::conf.renderThreads);
 
 	model::get().channels.clear();
 
@@ -319,11 +323,13 @@ void deleteChannel(ID channelId)
 	const std::vector<Plugin*> plugins = ch.plugins;
 #endif
 
-	u::vector::removeIf(model::get().channels, [channelId](const channel::Data& c) {
+	model::get().channels.removeIf([channelId](const channel::Data& c) {
 		return c.id == channelId;
 	});
 	model::swap(model::SwapType::HARD);
 
+	resamplerPool::release(channelId);
+
 	if (wave != nullptr)
 		model::remove<Wave>(*wave);
 
@@ -366,12 +372,12 @@ void setInToOut(bool v)
 
 float getInVol()
 {
-	return model::get().getChannel(mixer::MASTER_IN_CHANNEL_ID).volume;
+	return std::as_const(model::get()).getChannel(mixer::MASTER_IN_CHANNEL_ID).volume;
 }
 
 float getOutVol()
 {
-	return model::get().getChannel(mixer::MASTER_OUT_CHANNEL_ID).volume;
+	return std::as_const(model::get()).getChannel(mixer::MASTER_OUT_CHANNEL_ID).volume;
 }
 
 bool getInToOut()
@@ -25,7 +25,9 @@
  * -------------------------------------------------------------------------- */
 
 #include "core/model/model.h"
+#include <atomic>
 #include <cassert>
+#include <utility>
 #ifdef G_DEBUG_MODE
 #include "core/channels/channelManager.h"
 #endif
@@ -45,27 +47,55 @@ struct Data
 {
 	std::vector<std::unique_ptr<channel::Buffer>> channels;
 	std::vector<std::unique_ptr<Wave>>            waves;
-	recorder::ActionMap                           actions;
+	ActionTable                                   actions;
 #ifdef WITH_VST
 	std::vector<std::unique_ptr<Plugin>> plugins;
 #endif
+
+	/* waveIndex, pluginIndex
+	ID -> position in 'waves' and 'plugins'. Updated on add, rebuilt on 
+	remove and clear. */
+
+	IdIndex waveIndex;
+#ifdef WITH_VST
+	IdIndex pluginIndex;
+#endif
 };
 
 /* -------------------------------------------------------------------------- */
 
 template <typename T>
-auto getIter_(const std::vector<std::unique_ptr<T>>& source, ID id)
+ID getId_(const std::unique_ptr<T>& p)
+{
+	return p->id;
+}
+
+/* -------------------------------------------------------------------------- */
+
+template <typename S>
+auto* get_(S& source, const IdIndex& index, ID id)
+{
+	const int pos = index.find(source, id, getId_<typename S::value_type::element_type>);
+	return pos == -1 ? nullptr : source[pos].get();
+}
+
+/* -------------------------------------------------------------------------- */
+
+template <typename S>
+void reindex_(S& source, IdIndex& index)
 {
-	return u::vector::findIf(source, [id](const std::unique_ptr<T>& p) { return p->id == id; });
+	index.rebuild(source, getId_<typename S::value_type::element_type>);
 }
 
 /* -------------------------------------------------------------------------- */
 
+/* index_
+Indexes the element just appended to 'source', without a full reindex_. */
+
 template <typename S>
-auto* get_(S& source, ID id)
+void index_(S& source, IdIndex& index)
 {
-	auto it = getIter_(source, id);
-	return it == source.end() ? nullptr : it->get();
+	index.set(source.back()->id, static_cast<int>(source.size() - 1));
 }
 
 /* -------------------------------------------------------------------------- */
@@ -75,6 +105,13 @@ void remove_(D& dest, T& ref)
 {
 	u::vector::removeIf(dest, [&ref](const auto& other) { return other.get() == &ref; });
 }
+
+/* -------------------------------------------------------------------------- */
+
+ID getChannelId_(const channel::Data& c)
+{
+	return c.id;
+}
 } // namespace
 
 /* -------------------------------------------------------------------------- */
@@ -82,6 +119,7 @@ void remove_(D& dest, T& ref)
 /* -------------------------------------------------------------------------- */
 
 std::function<void(SwapType)> onSwap_ = nullptr;
+std::atomic<unsigned long>    version_ = 0;
 
 Swapper<Layout> layout;
 State           state;
@@ -106,16 +144,32 @@ DataLock::~DataLock()
 
 channel::Data& Layout::getChannel(ID id)
 {
-	return const_cast<channel::Data&>(const_cast<const Layout*>(this)->getChannel(id));
+	/* Look it up through the const interface, so that only the channel found
+	gets cloned (if shared). */
+
+	const int pos = channelIndex.find(std::as_const(channels), id, getChannelId_);
+	assert(pos != -1);
+	return channels[pos];
 }
 
 const channel::Data& Layout::getChannel(ID id) const
 {
-	auto it = std::find_if(channels.begin(), channels.end(), [id](const channel::Data& c) {
-		return c.id == id;
-	});
-	assert(it != channels.end());
-	return *it;
+	const channel::Data* ch = findChannel(id);
+	assert(ch != nullptr);
+	return *ch;
+}
+
+const channel::Data* Layout::findChannel(ID id) const
+{
+	const int pos = channelIndex.find(channels, id, getChannelId_);
+	return pos == -1 ? nullptr : &channels[pos];
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Layout::rebuildIndex()
+{
+	channelIndex.rebuild(std::as_const(channels), getChannelId_);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -141,7 +195,12 @@ Lock get_RT()
 
 void swap(SwapType t)
 {
+	/* The realtime thread gets the rebuilt index along with the layout. */
+
+	get().rebuildIndex();
 	layout.swap();
+	if (t != SwapType::SOFT)
+		version_.fetch_add(1);
 	triggerSwapCb(t);
 }
 
@@ -158,6 +217,13 @@ void triggerSwapCb(SwapType t)
 
 /* -------------------------------------------------------------------------- */
 
+unsigned long getVersion()
+{
+	return version_.load();
+}
+
+/* -------------------------------------------------------------------------- */
+
 bool isLocked()
 {
 	return layout.isLocked();
@@ -199,10 +265,10 @@ T* find(ID id)
 {
 #ifdef WITH_VST
 	if constexpr (std::is_same_v<T, Plugin>)
-		return get_(data.plugins, id);
+		return get_(data.plugins, data.pluginIndex, id);
 #endif
 	if constexpr (std::is_same_v<T, Wave>)
-		return get_(data.waves, id);
+		return get_(data.waves, data.waveIndex, id);
 
 	assert(false);
 }
@@ -219,10 +285,16 @@ void add(T obj)
 {
 #ifdef WITH_VST
 	if constexpr (std::is_same_v<T, PluginPtr>)
+	{
 		data.plugins.push_back(std::move(obj));
+		index_(data.plugins, data.pluginIndex);
+	}
 #endif
 	if constexpr (std::is_same_v<T, WavePtr>)
+	{
 		data.waves.push_back(std::move(obj));
+		index_(data.waves, data.waveIndex);
+	}
 	if constexpr (std::is_same_v<T, ChannelBufferPtr>)
 		data.channels.push_back(std::move(obj));
 	if constexpr (std::is_same_v<T, ChannelStatePtr>)
@@ -243,10 +315,16 @@ void remove(const T& ref)
 {
 #ifdef WITH_VST
 	if constexpr (std::is_same_v<T, Plugin>)
+	{
 		remove_(data.plugins, ref);
+		reindex_(data.plugins, data.pluginIndex);
+	}
 #endif
 	if constexpr (std::is_same_v<T, Wave>)
+	{
 		remove_(data.waves, ref);
+		reindex_(data.waves, data.waveIndex);
+	}
 }
 
 #ifdef WITH_VST
@@ -285,10 +363,16 @@ void clear()
 {
 #ifdef WITH_VST
 	if constexpr (std::is_same_v<T, PluginPtrs>)
+	{
 		data.plugins.clear();
+		reindex_(data.plugins, data.pluginIndex);
+	}
 #endif
 	if constexpr (std::is_same_v<T, WavePtrs>)
+	{
 		data.waves.clear();
+		reindex_(data.waves, data.waveIndex);
+	}
 }
 
 #ifdef WITH_VST
@@ -337,13 +421,9 @@ void debug()
 
 	puts("model::data.actions");
 
-	for (const auto& [frame, actions] : getAll<Actions>())
-	{
-		printf("\tframe: %d\n", frame);
-		for (const Action& a : actions)
-			printf("\t\t(%p) - ID=%d, frame=%d, channel=%d, value=0x%X, prevId=%d, prev=%p, nextId=%d, next=%p\n",
-			    (void*)&a, a.id, a.frame, a.channelId, a.event.getRaw(), a.prevId, (void*)a.prev, a.nextId, (void*)a.next);
-	}
+	for (const Action& a : getAll<Actions>())
+		printf("\t(%p) - ID=%d, frame=%d, channel=%d, value=0x%X, prevId=%d, prev=%p, nextId=%d, next=%p\n",
+		    (void*)&a, a.id, a.frame, a.channelId, a.event.getRaw(), a.prevId, (void*)a.prev, a.nextId, (void*)a.next);
 
 #ifdef WITH_VST
 
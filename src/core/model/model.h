@@ -29,6 +29,8 @@
 
 #include "core/channels/channel.h"
 #include "core/const.h"
+#include "core/cowVector.h"
+#include "core/idIndex.h"
 #include "core/plugins/plugin.h"
 #include "core/recorder.h"
 #include "core/swapper.h"
@@ -93,6 +95,9 @@ struct Mixer
 		std::atomic<bool> active  = false;
 		WeakAtomic<float> peakOut = 0.0f;
 		WeakAtomic<float> peakIn  = 0.0f;
+
+		WeakAtomic<int> skippedChannels = 0;
+		WeakAtomic<int> sleepingPlugins = 0;
 	};
 
 	State* state    = nullptr;
@@ -102,16 +107,42 @@ struct Mixer
 
 struct Layout
 {
+	/* getChannel
+	Returns the channel with the given ID, which must exist. O(1) through the
+	channel index. */
+
 	channel::Data&       getChannel(ID id);
 	const channel::Data& getChannel(ID id) const;
 
+	/* findChannel
+	Like getChannel(), but returns nullptr if the channel doesn't exist. */
+
+	const channel::Data* findChannel(ID id) const;
+
+	/* rebuildIndex
+	Rebuilds the channel index. Done on each swap: channels added or moved 
+	since then are still found, just through a linear search. */
+
+	void rebuildIndex();
+
 	Clock    clock;
 	Mixer    mixer;
 	Kernel   kernel;
 	Recorder recorder;
 	MidiIn   midiIn;
 
-	std::vector<channel::Data> channels;
+	/* channels
+	Each channel lives in its own shared node: swapping the Layout copies only
+	the channels modified since the last swap. Read channels through a const
+	Layout whenever possible, as non-const access clones shared channels. */
+
+	CowVector<channel::Data> channels;
+
+	/* channelIndex
+	Channel ID -> position in 'channels'. Internal channels are looked up on
+	every block through it. */
+
+	IdIndex channelIndex;
 
 	/* locked
 	If locked, Mixer won't process channels. This is used to allow editing the 
@@ -188,6 +219,13 @@ anyway (e.g. to update the UI). */
 
 void triggerSwapCb(SwapType t);
 
+/* getVersion
+Returns a counter bumped by every HARD or NONE swap, that is every change which
+is not a plain property update. Useful for caching data derived from the 
+layout. */
+
+unsigned long getVersion();
+
 bool isLocked();
 
 /* -------------------------------------------------------------------------- */
@@ -205,7 +243,7 @@ using ChannelStatePtr  = std::unique_ptr<channel::State>;
 using PluginPtrs = std::vector<PluginPtr>;
 #endif
 using WavePtrs          = std::vector<WavePtr>;
-using Actions           = recorder::ActionMap;
+using Actions           = ActionTable;
 using ChannelBufferPtrs = std::vector<ChannelBufferPtr>;
 using ChannelStatePtrs  = std::vector<ChannelStatePtr>;
 
@@ -32,6 +32,7 @@
 #include "core/patch.h"
 #include "core/plugins/pluginManager.h"
 #include "core/recorderHandler.h"
+#include "core/resamplerPool.h"
 #include "core/sequencer.h"
 #include "core/waveManager.h"
 #include <cassert>
@@ -53,6 +54,7 @@ void loadChannels_(const std::vector<patch::Channel>& channels, int samplerate)
 void loadActions_(const std::vector<patch::Action>& pactions)
 {
 	getAll<Actions>() = std::move(recorderHandler::deserializeActions(pactions));
+	recorder::refreshTimeline();
 }
 } // namespace
 
@@ -115,22 +117,23 @@ void load(const patch::Patch& patch)
 	get().channels = {};
 	getAll<ChannelBufferPtrs>().clear();
 	getAll<ChannelStatePtrs>().clear();
+	resamplerPool::releaseAll();
 
 	/* Load external data first: plug-ins and waves. */
 
 #ifdef WITH_VST
-	getAll<PluginPtrs>().clear();
+	clear<PluginPtrs>();
 	for (const patch::Plugin& pplugin : patch.plugins)
-		getAll<PluginPtrs>().push_back(pluginManager::deserializePlugin(pplugin, patch.version));
+		add(pluginManager::deserializePlugin(pplugin, patch.version));
 #endif
 
-	getAll<WavePtrs>().clear();
+	clear<WavePtrs>();
 	for (const patch::Wave& pwave : patch.waves)
 	{
 		std::unique_ptr<Wave> w = waveManager::deserializeWave(pwave, conf::conf.samplerate,
 		    conf::conf.rsmpQuality);
 		if (w != nullptr)
-			getAll<WavePtrs>().push_back(std::move(w));
+			add(std::move(w));
 	}
 
 	/* Then load up channels, actions and global properties. */
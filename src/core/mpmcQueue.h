@@ -0,0 +1,149 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_MPMC_QUEUE_H
+#define G_MPMC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace giada
+{
+namespace m
+{
+/* MpmcQueue
+Bounded multi-producer, multi-consumer lock-free queue. Each cell carries a
+sequence number that tells producers and consumers whether it is free, so that
+they only need to agree on the head/tail counters with a compare-and-swap. 
+Holds up to 'size' items; 'size' must be a power of two. Failed pushes are 
+counted, see countOverflows(). */
+
+template <typename T, std::size_t size>
+class MpmcQueue
+{
+	static_assert(size >= 2 && (size & (size - 1)) == 0, "MpmcQueue size must be a power of two");
+
+public:
+	MpmcQueue()
+	: m_head(0)
+	, m_tail(0)
+	, m_overflows(0)
+	{
+		for (std::size_t i = 0; i < size; i++)
+			m_cells[i].seq.store(i, std::memory_order_relaxed);
+	}
+
+	MpmcQueue(const MpmcQueue&) = delete;
+
+	bool pop(T& item)
+	{
+		Cell*       cell;
+		std::size_t pos = m_head.load(std::memory_order_relaxed);
+		while (true)
+		{
+			cell          = &m_cells[pos & MASK];
+			std::size_t s = cell->seq.load(std::memory_order_acquire);
+			intptr_t    d = static_cast<intptr_t>(s) - static_cast<intptr_t>(pos + 1);
+
+			if (d == 0 && m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+			if (d < 0) // Queue empty, nothing to do
+				return false;
+			if (d > 0) // Another consumer got here first, try again
+				pos = m_head.load(std::memory_order_relaxed);
+		}
+
+		item = std::move(cell->data);
+		cell->seq.store(pos + size, std::memory_order_release);
+		return true;
+	}
+
+	bool push(const T& item)
+	{
+		return pushWith([&item]() -> const T& { return item; });
+	}
+
+	/* pushWith
+	Like push(), but the item is built by calling 'make()' once a cell has been
+	reserved, that is only when the push can no longer fail. Keep 'make' short:
+	consumers can't get past the reserved cell until it returns. */
+
+	template <typename F>
+	bool pushWith(F&& make)
+	{
+		Cell*       cell;
+		std::size_t pos = m_tail.load(std::memory_order_relaxed);
+		while (true)
+		{
+			cell          = &m_cells[pos & MASK];
+			std::size_t s = cell->seq.load(std::memory_order_acquire);
+			intptr_t    d = static_cast<intptr_t>(s) - static_cast<intptr_t>(pos);
+
+			if (d == 0 && m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+			if (d < 0) // Queue full, nothing to do
+			{
+				m_overflows.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			if (d > 0) // Another producer got here first, try again
+				pos = m_tail.load(std::memory_order_relaxed);
+		}
+
+		cell->data = make();
+		cell->seq.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	/* countOverflows
+	Returns how many pushes have failed so far because the queue was full. */
+
+	std::size_t countOverflows() const
+	{
+		return m_overflows.load(std::memory_order_relaxed);
+	}
+
+  private:
+	static constexpr std::size_t MASK = size - 1;
+
+	struct Cell
+	{
+		std::atomic<std::size_t> seq;
+		T                        data;
+	};
+
+	std::array<Cell, size>               m_cells;
+	alignas(64) std::atomic<std::size_t> m_head;
+	alignas(64) std::atomic<std::size_t> m_tail;
+	std::atomic<std::size_t>             m_overflows;
+};
+} // namespace m
+} // namespace giada
+
+#endif
@@ -41,40 +41,42 @@ namespace giada::m::pluginHost
 {
 namespace
 {
-std::vector<Plugin*>     plugins_;
-juce::MessageManager*    messageManager_;
-juce::AudioBuffer<float> audioBuffer_;
-ID                       pluginId_;
+std::vector<Plugin*>  plugins_;
+juce::MessageManager* messageManager_;
+ID                    pluginId_;
 
 /* -------------------------------------------------------------------------- */
 
-void giadaToJuceTempBuf_(const AudioBuffer& outBuf)
+/* giadaToJuceTempBuf_
+Converts buffer from Giada (interleaved) to Juce (planar), one channel at a 
+time straight on the underlying arrays. */
+
+void giadaToJuceTempBuf_(const AudioBuffer& outBuf, juce::AudioBuffer<float>& juceBuf)
 {
-	for (int i = 0; i < outBuf.countFrames(); i++)
-		for (int j = 0; j < outBuf.countChannels(); j++)
-			audioBuffer_.setSample(j, i, outBuf[i][j]);
+	assert(outBuf.countChannels() <= juceBuf.getNumChannels());
+	outBuf.toPlanar(juceBuf.getArrayOfWritePointers());
 }
 
 /* juceToGiadaOutBuf_
 Converts buffer from Juce to Giada. A note for the future: if we overwrite (=) 
 (as we do now) it's SEND, if we add (+) it's INSERT. */
 
-void juceToGiadaOutBuf_(AudioBuffer& outBuf)
+void juceToGiadaOutBuf_(AudioBuffer& outBuf, const juce::AudioBuffer<float>& juceBuf)
 {
-	for (int i = 0; i < outBuf.countFrames(); i++)
-		for (int j = 0; j < outBuf.countChannels(); j++)
-			outBuf[i][j] = audioBuffer_.getSample(j, i);
+	assert(outBuf.countChannels() <= juceBuf.getNumChannels());
+	outBuf.fromPlanar(juceBuf.getArrayOfReadPointers());
 }
 
 /* -------------------------------------------------------------------------- */
 
-void processPlugins_(const std::vector<Plugin*>& plugins, juce::MidiBuffer& events)
+void processPlugins_(const std::vector<Plugin*>& plugins,
+    juce::AudioBuffer<float>& juceBuf, juce::MidiBuffer& events)
 {
 	for (Plugin* p : plugins)
 	{
 		if (!p->valid || p->isSuspended() || p->isBypassed())
 			continue;
-		p->process(audioBuffer_, events);
+		p->process(juceBuf, events);
 	}
 	events.clear();
 }
@@ -113,37 +115,31 @@ void close()
 
 /* -------------------------------------------------------------------------- */
 
-void init(int buffersize)
+void init()
 {
 	messageManager_ = juce::MessageManager::getInstance();
-	audioBuffer_.setSize(G_MAX_IO_CHANS, buffersize);
-	pluginId_ = 0;
+	pluginId_       = 0;
 }
 
 /* -------------------------------------------------------------------------- */
 
 void processStack(AudioBuffer& outBuf, const std::vector<Plugin*>& plugins,
-    juce::MidiBuffer* events)
+    juce::AudioBuffer<float>& juceBuf, juce::MidiBuffer& events, bool isMidiStack)
 {
-	assert(outBuf.countFrames() == audioBuffer_.getNumSamples());
+	assert(outBuf.countFrames() == juceBuf.getNumSamples());
 
-	/* If events are null: Audio stack processing (master in, master out or
-	sample channels. No need for MIDI events. 
-	If events are not null: MIDI stack (MIDI channels). MIDI channels must not 
-	process the current buffer: give them an empty and clean one. */
+	/* Audio stack (master in, master out or sample channels): the current
+	buffer goes through the plug-ins. 'events' is empty here, but it's still
+	handed over as a scratch area for plug-ins that generate MIDI. 
+	MIDI stack (MIDI channels): MIDI channels must not process the current 
+	buffer: give them an empty and clean one. */
 
-	if (events == nullptr)
-	{
-		giadaToJuceTempBuf_(outBuf);
-		juce::MidiBuffer dummyEvents; // empty
-		processPlugins_(plugins, dummyEvents);
-	}
+	if (isMidiStack)
+		juceBuf.clear();
 	else
-	{
-		audioBuffer_.clear();
-		processPlugins_(plugins, *events);
-	}
-	juceToGiadaOutBuf_(outBuf);
+		giadaToJuceTempBuf_(outBuf, juceBuf);
+	processPlugins_(plugins, juceBuf, events);
+	juceToGiadaOutBuf_(outBuf, juceBuf);
 }
 
 /* -------------------------------------------------------------------------- */
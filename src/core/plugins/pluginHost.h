@@ -48,7 +48,7 @@ struct Info : public juce::AudioPlayHead
 
 /* -------------------------------------------------------------------------- */
 
-void init(int buffersize);
+void init();
 void close();
 
 /* addPlugin
@@ -57,10 +57,14 @@ Adds a new plugin to channel 'channelId'. */
 void addPlugin(std::unique_ptr<Plugin> p, ID channelId);
 
 /* processStack
-Applies the fx list to the buffer. */
+Applies the fx list to the buffer. 'juceBuf' and 'events' are preallocated 
+scratch buffers owned by the caller (see channel::Buffer): no state is shared
+between calls, so stacks belonging to different channels can be processed 
+concurrently. 'events' is cleared once done. If 'isMidiStack' is true the 
+plug-ins receive silence instead of the content of 'outBuf'. */
 
 void processStack(AudioBuffer& outBuf, const std::vector<Plugin*>& plugins,
-    juce::MidiBuffer* events = nullptr);
+    juce::AudioBuffer<float>& juceBuf, juce::MidiBuffer& events, bool isMidiStack = false);
 
 /* swapPlugin 
 Swaps plug-in 1 with plug-in 2 in Channel 'channelId'. */
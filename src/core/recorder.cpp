@@ -26,12 +26,14 @@
 
 #include "core/recorder.h"
 #include "core/action.h"
+#include "core/const.h"
 #include "core/idManager.h"
 #include "core/model/model.h"
 #include "utils/log.h"
 #include <algorithm>
 #include <cassert>
 #include <memory>
+#include <unordered_set>
 
 namespace giada::m::recorder
 {
@@ -39,48 +41,37 @@ namespace
 {
 IdManager actionId_;
 
-/* -------------------------------------------------------------------------- */
+Timeline timeline_;
 
-Action* findAction_(ActionMap& src, ID id)
-{
-	for (auto& [frame, actions] : src)
-		for (Action& a : actions)
-			if (a.id == id)
-				return &a;
-	assert(false);
-	return nullptr;
-}
+/* ActionKey_
+What makes an action unique: two actions with the same key are duplicates. */
 
-/* -------------------------------------------------------------------------- */
+struct ActionKey_
+{
+	Frame    frame;
+	ID       channelId;
+	uint32_t raw;
 
-/* updateMapPointers_
-Updates all prev/next actions pointers into the action map. This is required
-after an action has been recorded, since pushing back new actions in a Action 
-vector makes it reallocating the existing ones. */
+	bool operator==(const ActionKey_& o) const
+	{
+		return frame == o.frame && channelId == o.channelId && raw == o.raw;
+	}
+};
 
-void updateMapPointers_(ActionMap& src)
+struct KeyHash_
 {
-	for (auto& kv : src)
+	std::size_t operator()(const ActionKey_& k) const
 	{
-		for (Action& action : kv.second)
-		{
-			if (action.nextId != 0)
-				action.next = findAction_(src, action.nextId);
-			if (action.prevId != 0)
-				action.prev = findAction_(src, action.prevId);
-		}
+		return std::hash<uint64_t>()((static_cast<uint64_t>(k.frame) << 32) ^ k.raw) ^
+		       std::hash<ID>()(k.channelId);
 	}
-}
+};
 
 /* -------------------------------------------------------------------------- */
 
-/* optimize
-Removes frames without actions. */
-
-void optimize_(ActionMap& map)
+ActionTable& getTable_()
 {
-	for (auto it = map.cbegin(); it != map.cend();)
-		it->second.size() == 0 ? it = map.erase(it) : ++it;
+	return model::getAll<model::Actions>();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -89,27 +80,23 @@ void removeIf_(std::function<bool(const Action&)> f)
 {
 	model::DataLock lock;
 
-	ActionMap& map = model::getAll<model::Actions>();
-	for (auto& [frame, actions] : map)
-		actions.erase(std::remove_if(actions.begin(), actions.end(), f), actions.end());
-	optimize_(map);
-	updateMapPointers_(map);
+	getTable_().removeIf(f);
+	refreshTimeline();
 }
 
 /* -------------------------------------------------------------------------- */
 
-bool exists_(ID channelId, Frame frame, const MidiEvent& event, const ActionMap& target)
+bool exists_(ID channelId, Frame frame, const MidiEvent& event, const ActionTable& target)
 {
-	for (const auto& [_, actions] : target)
-		for (const Action& a : actions)
-			if (a.channelId == channelId && a.frame == frame && a.event.getRaw() == event.getRaw())
-				return true;
+	for (const Action& a : target.getFrame(frame))
+		if (a.channelId == channelId && a.event.getRaw() == event.getRaw())
+			return true;
 	return false;
 }
 
 bool exists_(ID channelId, Frame frame, const MidiEvent& event)
 {
-	return exists_(channelId, frame, event, model::getAll<model::Actions>());
+	return exists_(channelId, frame, event, getTable_());
 }
 } // namespace
 
@@ -128,7 +115,8 @@ void init()
 void clearAll()
 {
 	model::DataLock lock;
-	model::getAll<model::Actions>().clear();
+	getTable_().clear();
+	refreshTimeline();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -163,27 +151,9 @@ void deleteAction(ID currId, ID nextId)
 
 void updateKeyFrames(std::function<Frame(Frame old)> f)
 {
-	recorder::ActionMap temp;
-
-	/* Copy all existing actions in local map by cloning them, with just a
-	difference: they have a new frame value. */
-
-	for (const auto& [oldFrame, actions] : model::getAll<model::Actions>())
-	{
-		Frame newFrame = f(oldFrame);
-		for (const Action& a : actions)
-		{
-			Action copy = a;
-			copy.frame  = newFrame;
-			temp[newFrame].push_back(copy);
-		}
-		G_DEBUG(oldFrame << " -> " << newFrame);
-	}
-
-	updateMapPointers_(temp);
-
 	model::DataLock lock;
-	model::getAll<model::Actions>() = std::move(temp);
+	getTable_().updateFrames(f);
+	refreshTimeline();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -191,7 +161,12 @@ void updateKeyFrames(std::function<Frame(Frame old)> f)
 void updateEvent(ID id, MidiEvent e)
 {
 	model::DataLock lock;
-	findAction_(model::getAll<model::Actions>(), id)->event = e;
+
+	Action* a = getTable_().find(id);
+	assert(a != nullptr);
+	a->event = e;
+
+	refreshTimeline();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -200,36 +175,40 @@ void updateSiblings(ID id, ID prevId, ID nextId)
 {
 	model::DataLock lock;
 
-	Action* pcurr = findAction_(model::getAll<model::Actions>(), id);
-	Action* pprev = findAction_(model::getAll<model::Actions>(), prevId);
-	Action* pnext = findAction_(model::getAll<model::Actions>(), nextId);
+	ActionTable& table = getTable_();
+
+	Action* pcurr = table.find(id);
+	Action* pprev = table.find(prevId);
+	Action* pnext = table.find(nextId);
 
-	pcurr->prev   = pprev;
-	pcurr->prevId = pprev->id;
-	pcurr->next   = pnext;
-	pcurr->nextId = pnext->id;
+	assert(pcurr != nullptr);
 
+	pcurr->prevId = prevId;
+	pcurr->nextId = nextId;
 	if (pprev != nullptr)
-	{
-		pprev->next   = pcurr;
-		pprev->nextId = pcurr->id;
-	}
+		pprev->nextId = id;
 	if (pnext != nullptr)
-	{
-		pnext->prev   = pcurr;
-		pnext->prevId = pcurr->id;
-	}
+		pnext->prevId = id;
+
+	table.link();
 }
 
 /* -------------------------------------------------------------------------- */
 
 bool hasActions(ID channelId, int type)
 {
-	for (const auto& [frame, actions] : model::getAll<model::Actions>())
-		for (const Action& a : actions)
-			if (a.channelId == channelId && (type == 0 || type == a.event.getStatus()))
-				return true;
-	return false;
+	const ActionTable& table = getTable_();
+
+	if (!table.hasChannel(channelId))
+		return false;
+	if (type == 0)
+		return true;
+
+	bool found = false;
+	table.forEachOnChannel(channelId, [&](const Action& a) {
+		found = found || type == a.event.getStatus();
+	});
+	return found;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -257,15 +236,14 @@ Action rec(ID channelId, Frame frame, MidiEvent event)
 	if (exists_(channelId, frame, event))
 		return {};
 
-	Action a = makeAction(0, channelId, frame, event);
+	/* No plug-in data for now. */
 
-	/* If key frame doesn't exist yet, the [] operator in std::map is smart 
-	enough to insert a new item first. No plug-in data for now. */
+	Action a = makeAction(0, channelId, frame, event);
 
 	model::DataLock lock;
 
-	model::getAll<model::Actions>()[frame].push_back(a);
-	updateMapPointers_(model::getAll<model::Actions>());
+	getTable_().insert(a);
+	refreshTimeline();
 
 	return a;
 }
@@ -279,12 +257,26 @@ void rec(std::vector<Action>& actions)
 
 	model::DataLock lock;
 
-	ActionMap& map = model::getAll<model::Actions>();
+	ActionTable& table = getTable_();
+
+	/* Skip duplicates, both against the table and within the batch itself. */
+
+	std::vector<Action>                      batch;
+	std::unordered_set<ActionKey_, KeyHash_> seen;
+	batch.reserve(actions.size());
+	seen.reserve(actions.size());
 
 	for (const Action& a : actions)
-		if (!exists_(a.channelId, a.frame, a.event, map))
-			map[a.frame].push_back(a);
-	updateMapPointers_(map);
+	{
+		if (exists_(a.channelId, a.frame, a.event, table))
+			continue;
+		if (!seen.insert({a.frame, a.channelId, a.event.getRaw()}).second)
+			continue;
+		batch.push_back(a);
+	}
+
+	table.insert(batch);
+	refreshTimeline();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -293,26 +285,54 @@ void rec(ID channelId, Frame f1, Frame f2, MidiEvent e1, MidiEvent e2)
 {
 	model::DataLock lock;
 
-	ActionMap& map = model::getAll<model::Actions>();
+	Action a1 = makeAction(0, channelId, f1, e1);
+	Action a2 = makeAction(0, channelId, f2, e2);
+	a1.nextId = a2.id;
+	a2.prevId = a1.id;
+
+	getTable_().insert({a1, a2});
+	refreshTimeline();
+}
+
+/* -------------------------------------------------------------------------- */
 
-	map[f1].push_back(makeAction(0, channelId, f1, e1));
-	map[f2].push_back(makeAction(0, channelId, f2, e2));
+ActionTable::View getActionsOnFrame(Frame frame)
+{
+	return getTable_().getFrame(frame);
+}
 
-	Action* a1 = findAction_(map, map[f1].back().id);
-	Action* a2 = findAction_(map, map[f2].back().id);
-	a1->nextId = a2->id;
-	a2->prevId = a1->id;
+/* -------------------------------------------------------------------------- */
 
-	updateMapPointers_(map);
+const Timeline& getTimeline()
+{
+	return timeline_;
 }
 
 /* -------------------------------------------------------------------------- */
 
-const std::vector<Action>* getActionsOnFrame(Frame frame)
+void refreshTimeline()
 {
-	if (model::getAll<model::Actions>().count(frame) == 0)
-		return nullptr;
-	return &model::getAll<model::Actions>().at(frame);
+	const ActionTable& table = getTable_();
+
+	timeline_.frames.clear();
+	timeline_.actions.clear();
+	timeline_.envelopes.clear();
+
+	for (auto it = table.begin(); it != table.end();)
+	{
+		auto last = std::find_if(it, table.end(), [f = it->frame](const Action& a) { return a.frame != f; });
+		timeline_.frames.push_back(it->frame);
+		timeline_.actions.push_back(ActionTable::View(&*it, &*it + (last - it)));
+		it = last;
+	}
+
+	/* Compile volume envelopes: the table is sorted by frame, so are points. */
+
+	for (const Action& a : table)
+		if (a.isVolumeEnvelope())
+			timeline_.envelopes[a.channelId].add(a.frame, a.event.getVelocity() / static_cast<float>(G_MAX_VELOCITY));
+
+	timeline_.version++;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -320,8 +340,8 @@ const std::vector<Action>* getActionsOnFrame(Frame frame)
 Action getClosestAction(ID channelId, Frame f, int type)
 {
 	Action out = {};
-	forEachAction([&](const Action& a) {
-		if (a.event.getStatus() != type || a.channelId != channelId)
+	getTable_().forEachOnChannel(channelId, [&](const Action& a) {
+		if (a.event.getStatus() != type)
 			return;
 		if (!out.isValid() || (a.frame <= f && a.frame > out.frame))
 			out = a;
@@ -334,9 +354,8 @@ Action getClosestAction(ID channelId, Frame f, int type)
 std::vector<Action> getActionsOnChannel(ID channelId)
 {
 	std::vector<Action> out;
-	forEachAction([&](const Action& a) {
-		if (a.channelId == channelId)
-			out.push_back(a);
+	getTable_().forEachOnChannel(channelId, [&](const Action& a) {
+		out.push_back(a);
 	});
 	return out;
 }
@@ -345,9 +364,8 @@ std::vector<Action> getActionsOnChannel(ID channelId)
 
 void forEachAction(std::function<void(const Action&)> f)
 {
-	for (auto& [_, actions] : model::getAll<model::Actions>())
-		for (const Action& action : actions)
-			f(action);
+	for (const Action& action : getTable_())
+		f(action);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -28,17 +28,32 @@
 #define G_RECORDER_H
 
 #include "core/action.h"
+#include "core/actionTable.h"
+#include "core/envelope.h"
 #include "core/midiEvent.h"
 #include "core/patch.h"
 #include "core/types.h"
 #include <functional>
-#include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace giada::m::recorder
 {
-using ActionMap = std::map<Frame, std::vector<Action>>;
+/* Timeline
+Frame-sorted index of the ActionTable for sequential reading on the realtime
+thread: 'frames[i]' holds the actions in 'actions[i]'. Frames live in their own
+contiguous vector to keep searches cache-friendly. 'version' changes on every
+rebuild, so readers can tell when a cached position is stale. 'envelopes' holds
+the volume envelope of each channel that has one, ready to be rendered. */
+
+struct Timeline
+{
+	std::vector<Frame>               frames;
+	std::vector<ActionTable::View>   actions;
+	std::unordered_map<ID, Envelope> envelopes;
+	int                              version = 0;
+};
 
 /* init
 Initializes the recorder: everything starts from here. */
@@ -71,8 +86,8 @@ Deletes a specific pair of actions. Useful for composite stuff (i.e. MIDI). */
 void deleteAction(ID currId, ID nextId);
 
 /* updateKeyFrames
-Update all the key frames in the internal map of actions, according to a lambda 
-function 'f'. */
+Update all the key frames in the internal table of actions, according to a 
+lambda function 'f'. */
 
 void updateKeyFrames(std::function<Frame(Frame old)> f);
 
@@ -104,7 +119,7 @@ Records an action and returns it. Used by the Action Editor. */
 Action rec(ID channelId, Frame frame, MidiEvent e);
 
 /* rec (2)
-Transfer a vector of actions into the current ActionMap. This is called by 
+Transfer a vector of actions into the current ActionTable. This is called by 
 recordHandler when a live session is over and consolidation is required. */
 
 void rec(std::vector<Action>& actions);
@@ -117,15 +132,28 @@ void rec(ID channelId, Frame f1, Frame f2, MidiEvent e1, MidiEvent e2);
 
 /* forEachAction
 Applies a read-only callback on each action recorded. NEVER do anything inside 
-the callback that might alter the ActionMap. */
+the callback that might alter the ActionTable. */
 
 void forEachAction(std::function<void(const Action&)> f);
 
 /* getActionsOnFrame
-Returns a pointer to a vector of actions recorded on frame 'f', or nullptr if
-the frame has no actions. */
+Returns the actions recorded on frame 'f'. The View is empty if the frame has
+no actions. */
+
+ActionTable::View getActionsOnFrame(Frame f);
+
+/* getTimeline
+[realtime] Returns the Timeline of the current ActionTable. Don't read it while
+the model is locked (i.e. model::Layout::locked == true): it might be under 
+reconstruction. */
+
+const Timeline& getTimeline();
+
+/* refreshTimeline
+Rebuilds the Timeline. Call it under model::DataLock after having modified the 
+ActionTable without going through the functions above. */
 
-const std::vector<Action>* getActionsOnFrame(Frame f);
+void refreshTimeline();
 
 /* getActionsOnChannel
 Returns a vector of actions belonging to channel 'ch'. */
@@ -30,78 +30,94 @@
 #include "const.h"
 #include "model/model.h"
 #include "patch.h"
+#include "queue.h"
 #include "recorder.h"
 #include "utils/log.h"
 #include "utils/ver.h"
+#include "worker.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cmath>
+#include <deque>
+#include <mutex>
 #include <unordered_map>
 
 namespace giada::m::recorderHandler
 {
 namespace
 {
-constexpr int MAX_LIVE_RECS_CHUNK = 128;
+/* liveRecs_
+Lock-free capture ring filled by liveRec(), never allocates. Single producer:
+the thread where channels react to events. */
 
-std::vector<Action> recs_;
+Queue<Action, G_MAX_LIVE_RECS> liveRecs_;
 
-/* -------------------------------------------------------------------------- */
+/* droppedLiveRecs_
+Number of live actions lost because the capture ring was full. */
 
-const Action* getActionPtrById_(int id, const recorder::ActionMap& source)
-{
-	for (const auto& [_, actions] : source)
-		for (const Action& action : actions)
-			if (action.id == id)
-				return &action;
-	return nullptr;
-}
+std::atomic<int> droppedLiveRecs_(0);
 
-/* -------------------------------------------------------------------------- */
+/* reportedLiveRecs_
+Lost live actions already logged. Protected by recsMutex_. */
 
-/* areComposite_
-Composite: NOTE_ON + NOTE_OFF on the same note. */
+int reportedLiveRecs_ = 0;
 
-bool areComposite_(const Action& a1, const Action& a2)
-{
-	return a1.event.getStatus() == MidiEvent::NOTE_ON &&
-	       a2.event.getStatus() == MidiEvent::NOTE_OFF &&
-	       a1.event.getNote() == a2.event.getNote() &&
-	       a1.channelId == a2.channelId;
-}
+/* recs_, openNotes_
+Live actions drained from the capture ring so far, and the NOTE_ONs among them 
+still waiting for a NOTE_OFF, as indexes in recs_ keyed by (channel, note). 
+Both are protected by recsMutex_: the ring is drained either by the background 
+consolidator or by consolidate(). */
+
+std::vector<Action>                                    recs_;
+std::unordered_map<uint64_t, std::deque<std::size_t>> openNotes_;
+std::mutex                                             recsMutex_;
+
+Worker consolidator_;
 
 /* -------------------------------------------------------------------------- */
 
-/* consolidate_
-Given an action 'a1' tries to find the matching NOTE_OFF. This algorithm must
-start searching from the element next to 'a1': since live actions are recorded
-in linear sequence, the potential partner of 'a1' always lies beyond a1 itself. 
-Without this trick (i.e. if it loops from vector.begin() each time) the
-algorithm would end up matching wrong partners. */
+/* pair_
+Pairs the i-th action in recs_ with the NOTE_ON it closes, if any. Overlapping
+notes with the same key are paired first-in first-out, so that each NOTE_OFF 
+closes the oldest NOTE_ON still open. */
 
-void consolidate_(const Action& a1, std::size_t i)
+void pair_(std::size_t i)
 {
-	for (auto it = recs_.begin() + i; it != recs_.end(); ++it)
-	{
+	Action&        a      = recs_[i];
+	const uint64_t key    = (static_cast<uint64_t>(a.channelId) << 8) | a.event.getNote();
+	const int      status = a.event.getStatus();
 
-		const Action& a2 = *it;
-
-		if (!areComposite_(a1, a2))
-			continue;
+	if (status == MidiEvent::NOTE_ON)
+		openNotes_[key].push_back(i);
+	else if (status == MidiEvent::NOTE_OFF)
+	{
+		auto it = openNotes_.find(key);
+		if (it == openNotes_.end() || it->second.empty())
+			return;
 
-		const_cast<Action&>(a1).nextId = a2.id;
-		const_cast<Action&>(a2).prevId = a1.id;
+		Action& on = recs_[it->second.front()];
+		it->second.pop_front();
 
-		break;
+		on.nextId = a.id;
+		a.prevId  = on.id;
 	}
 }
 
 /* -------------------------------------------------------------------------- */
 
-void consolidate_()
+/* drain_
+Moves live actions from the capture ring to recs_, pairing them on the way. 
+Call it with recsMutex_ locked. */
+
+void drain_()
 {
-	for (auto it = recs_.begin(); it != recs_.end(); ++it)
-		consolidate_(*it, it - recs_.begin()); // Pass current index
+	Action a;
+	while (liveRecs_.pop(a))
+	{
+		recs_.push_back(a);
+		pair_(recs_.size() - 1);
+	}
 }
 } // namespace
 
@@ -111,7 +127,10 @@ void consolidate_()
 
 void init()
 {
-	recs_.reserve(MAX_LIVE_RECS_CHUNK);
+	recs_.reserve(G_MAX_LIVE_RECS);
+
+	consolidator_.stop();
+	consolidator_.start(drainLiveRecs, G_LIVE_RECS_DRAIN_TIME);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -200,18 +219,25 @@ void liveRec(ID channelId, MidiEvent e, Frame globalFrame)
 {
 	assert(e.isNoteOnOff()); // Can't record any other kind of events for now
 
-	/* TODO - this might allocate on the MIDI thread */
-	if (recs_.size() >= recs_.capacity())
-		recs_.reserve(recs_.size() + MAX_LIVE_RECS_CHUNK);
+	if (!liveRecs_.push(recorder::makeAction(recorder::getNewActionId(), channelId, globalFrame, e)))
+		droppedLiveRecs_.fetch_add(1);
+}
+
+/* -------------------------------------------------------------------------- */
 
-	recs_.push_back(recorder::makeAction(recorder::getNewActionId(), channelId, globalFrame, e));
+void drainLiveRecs()
+{
+	std::scoped_lock lock(recsMutex_);
+	drain_();
 }
 
 /* -------------------------------------------------------------------------- */
 
 std::unordered_set<ID> consolidate()
 {
-	consolidate_();
+	std::scoped_lock lock(recsMutex_);
+
+	drain_();
 	recorder::rec(recs_);
 
 	std::unordered_set<ID> out;
@@ -219,11 +245,27 @@ std::unordered_set<ID> consolidate()
 		out.insert(action.channelId);
 
 	recs_.clear();
+	openNotes_.clear();
+
+	if (int dropped = droppedLiveRecs_.load(); dropped > reportedLiveRecs_)
+	{
+		u::log::print("[recorderHandler::consolidate] %d live actions lost, capture ring full\n",
+		    dropped - reportedLiveRecs_);
+		reportedLiveRecs_ = dropped;
+	}
+
 	return out;
 }
 
 /* -------------------------------------------------------------------------- */
 
+int countDroppedLiveRecs()
+{
+	return droppedLiveRecs_.load();
+}
+
+/* -------------------------------------------------------------------------- */
+
 void clearAllActions()
 {
 	for (channel::Data& ch : model::get().channels)
@@ -236,58 +278,37 @@ void clearAllActions()
 
 /* -------------------------------------------------------------------------- */
 
-recorder::ActionMap deserializeActions(const std::vector<patch::Action>& pactions)
+ActionTable deserializeActions(const std::vector<patch::Action>& pactions)
 {
-	recorder::ActionMap out;
-
-	/* First pass: add actions with no relationship, that is with no prev/next
-	pointers filled in. */
-
+	std::vector<Action> actions;
+	actions.reserve(pactions.size());
 	for (const patch::Action& paction : pactions)
-		out[paction.frame].push_back(recorder::makeAction(paction));
+		actions.push_back(recorder::makeAction(paction));
 
-	/* Second pass: fill in previous and next actions, if any. Is this the
-	fastest/smartest way to do it? Maybe not. Optimizations are welcome. */
-
-	for (const patch::Action& paction : pactions)
-	{
-		if (paction.nextId == 0 && paction.prevId == 0)
-			continue;
-		Action* curr = const_cast<Action*>(getActionPtrById_(paction.id, out));
-		assert(curr != nullptr);
-		if (paction.nextId != 0)
-		{
-			curr->next = getActionPtrById_(paction.nextId, out);
-			assert(curr->next != nullptr);
-		}
-		if (paction.prevId != 0)
-		{
-			curr->prev = getActionPtrById_(paction.prevId, out);
-			assert(curr->prev != nullptr);
-		}
-	}
+	/* The table fills in previous and next pointers on its own, given the IDs
+	stored in the patch. */
 
+	ActionTable out;
+	out.insert(actions);
 	return out;
 }
 
 /* -------------------------------------------------------------------------- */
 
-std::vector<patch::Action> serializeActions(const recorder::ActionMap& actions)
+std::vector<patch::Action> serializeActions(const ActionTable& actions)
 {
 	std::vector<patch::Action> out;
-	for (const auto& kv : actions)
+	out.reserve(actions.size());
+	for (const Action& a : actions)
 	{
-		for (const Action& a : kv.second)
-		{
-			out.push_back({
-			    a.id,
-			    a.channelId,
-			    a.frame,
-			    a.event.getRaw(),
-			    a.prevId,
-			    a.nextId,
-			});
-		}
+		out.push_back({
+		    a.id,
+		    a.channelId,
+		    a.frame,
+		    a.event.getRaw(),
+		    a.prevId,
+		    a.nextId,
+		});
 	}
 	return out;
 }
@@ -65,16 +65,31 @@ whether any action has been cloned. */
 bool cloneActions(ID channelId, ID newChannelId);
 
 /* liveRec
-Records a user-generated action. NOTE_ON or NOTE_OFF only for now. */
+Records a user-generated action. NOTE_ON or NOTE_OFF only for now. Lock-free
+and allocation-free: the action goes into a fixed-size capture ring, or gets
+dropped (and counted) if the ring is full. */
 
 void liveRec(ID channelId, MidiEvent e, Frame global);
 
+/* drainLiveRecs
+Moves live actions from the capture ring to the consolidation area, pairing
+NOTE_ONs with NOTE_OFFs. A background thread calls it periodically while the
+engine runs, so that the ring never fills up in long sessions. */
+
+void drainLiveRecs();
+
 /* consolidate
 Records all live actions. Returns a set of channels IDs that have been 
 recorded. */
 
 std::unordered_set<ID> consolidate();
 
+/* countDroppedLiveRecs
+Returns how many live actions have been lost so far because the capture ring
+was full. */
+
+int countDroppedLiveRecs();
+
 /* clearAllActions
 Deletes all recorded actions. */
 
@@ -83,8 +98,8 @@ void clearAllActions();
 /* (de)serializeActions
 Creates new Actions given the patch raw data and vice versa. */
 
-recorder::ActionMap        deserializeActions(const std::vector<patch::Action>& as);
-std::vector<patch::Action> serializeActions(const recorder::ActionMap& as);
+ActionTable                deserializeActions(const std::vector<patch::Action>& as);
+std::vector<patch::Action> serializeActions(const ActionTable& as);
 } // namespace giada::m::recorderHandler
 
 #endif
@@ -0,0 +1,205 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "renderPool.h"
+#include "core/const.h"
+#include <cassert>
+#ifdef G_OS_WINDOWS
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace giada
+{
+namespace
+{
+/* MAX_SPINS
+How many times the calling thread polls helpers still busy before yielding the
+CPU, in case one of them has been preempted. */
+
+constexpr int MAX_SPINS = 1024;
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+RenderPool::RenderPool()
+: m_running(false)
+, m_ticket(0)
+, m_count(0)
+, m_done(0)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+RenderPool::~RenderPool()
+{
+	stop();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderPool::start(int threads, Job job, int priority)
+{
+	stop();
+
+	m_job = job;
+	m_running.store(true);
+
+	for (int i = 1; i < threads; i++)
+	{
+		Semaphore& wakeup = *m_wakeups.emplace_back(std::make_unique<Semaphore>());
+		m_threads.emplace_back([this, &wakeup, priority]() { helperLoop(wakeup, priority); });
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderPool::stop()
+{
+	m_running.store(false);
+	for (std::unique_ptr<Semaphore>& wakeup : m_wakeups)
+		wakeup->post();
+
+	for (std::thread& t : m_threads)
+		if (t.joinable())
+			t.join();
+	m_threads.clear();
+	m_wakeups.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderPool::run(std::size_t count)
+{
+	assert(m_job != nullptr);
+
+	if (count == 0)
+		return;
+
+	/* No helpers: just run everything on the calling thread. */
+
+	if (m_threads.size() == 0)
+	{
+		for (std::size_t i = 0; i < count; i++)
+			m_job(i);
+		return;
+	}
+
+	/* Publish the new batch. The ticket is first moved to the new generation
+	with an exhausted index, so that helpers still looking at the previous batch
+	can't claim anything while count and done are being reset. */
+
+	const std::uint32_t gen  = static_cast<std::uint32_t>(m_ticket.load() >> GEN_SHIFT) + 1;
+	const std::uint64_t base = static_cast<std::uint64_t>(gen) << GEN_SHIFT;
+
+	m_ticket.store(base | INDEX_MASK);
+	m_count.store(count);
+	m_done.store(0);
+	m_ticket.store(base);
+
+	for (std::unique_ptr<Semaphore>& wakeup : m_wakeups)
+		wakeup->post();
+
+	process(gen);
+
+	/* All jobs have been claimed by now: wait for helpers still busy with the
+	last ones. They run with the same priority, so the wait is short: yield the
+	CPU only if it takes longer than expected. */
+
+	for (int spins = 0; m_done.load() < count; spins++)
+		if (spins >= MAX_SPINS)
+			std::this_thread::yield();
+}
+
+/* -------------------------------------------------------------------------- */
+
+int RenderPool::countThreads() const
+{
+	return static_cast<int>(m_threads.size()) + 1;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderPool::process(std::uint32_t gen)
+{
+	std::uint64_t ticket = m_ticket.load();
+	while (true)
+	{
+		const std::uint32_t currGen = static_cast<std::uint32_t>(ticket >> GEN_SHIFT);
+		const std::size_t   index   = static_cast<std::size_t>(ticket & INDEX_MASK);
+
+		if (currGen != gen || index >= m_count.load())
+			return;
+		if (!m_ticket.compare_exchange_weak(ticket, ticket + 1))
+			continue; // 'ticket' has been refreshed by compare_exchange_weak
+
+		m_job(index);
+		m_done.fetch_add(1);
+		ticket = m_ticket.load();
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderPool::applyPriority(int priority)
+{
+	/* Failures (e.g. missing permissions for realtime scheduling) are not 
+	fatal: the helper just keeps its current priority. */
+
+#ifdef G_OS_WINDOWS
+	(void)priority;
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#else
+	sched_param param {};
+	param.sched_priority = priority;
+	pthread_setschedparam(pthread_self(), SCHED_RR, &param);
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderPool::helperLoop(Semaphore& wakeup, int priority)
+{
+	if (priority > 0)
+		applyPriority(priority);
+
+	/* One post per batch. A helper still busy when a batch starts finds the
+	post later on and joins in, if there's anything left to do. */
+
+	while (true)
+	{
+		wakeup.wait();
+		if (!m_running.load())
+			return;
+		process(static_cast<std::uint32_t>(m_ticket.load() >> GEN_SHIFT));
+	}
+}
+} // namespace giada
@@ -0,0 +1,114 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_RENDER_POOL_H
+#define G_RENDER_POOL_H
+
+#include "core/semaphore.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace giada
+{
+/* RenderPool
+A fixed-size pool of helper threads that executes a job function over a range of
+indexes [0, count). The calling thread always takes part in the processing, so
+a pool with N threads spawns N - 1 helpers. Jobs are distributed with a single
+lock-free ticket and helpers are woken up through their own semaphore: run() 
+never allocates nor takes a lock. Helpers run with the scheduling priority 
+passed to start(), i.e. the one of the audio thread, so that the latter never 
+waits for a lower priority thread. */
+
+class RenderPool
+{
+public:
+	using Job = std::function<void(std::size_t)>;
+
+	RenderPool();
+	RenderPool(const RenderPool&) = delete;
+	~RenderPool();
+
+	/* start
+	Spawns 'threads' - 1 helper threads that will execute 'job' on each index
+	passed to run(). Helpers get realtime priority 'priority' (SCHED_RR on 
+	POSIX, time critical on Windows), or keep the default one if 'priority' is
+	0. Stops any previously running helper first. */
+
+	void start(int threads, Job job, int priority = 0);
+
+	/* stop
+	Stops and joins all helper threads. */
+
+	void stop();
+
+	/* run
+	[realtime] Executes the job on indexes [0, count) and returns when all of 
+	them have been processed. The calling thread picks up any job the helpers
+	haven't claimed yet, so it only ever waits for jobs already running. */
+
+	void run(std::size_t count);
+
+	/* countThreads
+	Returns the number of threads taking part in a run, caller included. */
+
+	int countThreads() const;
+
+private:
+	/* Ticket layout: upper 32 bits hold the batch generation, lower 32 bits 
+	the next index to process. Packing them together prevents a late helper 
+	from stealing indexes belonging to a different batch. */
+
+	static constexpr int           GEN_SHIFT  = 32;
+	static constexpr std::uint64_t INDEX_MASK = 0xFFFFFFFF;
+
+	/* process
+	Grabs and executes jobs belonging to batch 'gen' until there are none 
+	left. */
+
+	void process(std::uint32_t gen);
+
+	void helperLoop(Semaphore& wakeup, int priority);
+
+	/* applyPriority
+	Sets realtime priority 'priority' on the calling thread. */
+
+	static void applyPriority(int priority);
+
+	std::vector<std::thread>                m_threads;
+	std::vector<std::unique_ptr<Semaphore>> m_wakeups;
+	Job                                     m_job;
+	std::atomic<bool>                       m_running;
+	std::atomic<std::uint64_t>              m_ticket;
+	std::atomic<std::size_t>                m_count;
+	std::atomic<std::size_t>                m_done;
+};
+} // namespace giada
+
+#endif
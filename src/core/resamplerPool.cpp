@@ -0,0 +1,138 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/resamplerPool.h"
+#include "core/const.h"
+#include "utils/log.h"
+#include <cassert>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+namespace giada::m::resamplerPool
+{
+namespace
+{
+struct SrcDeleter_
+{
+	void operator()(SRC_STATE* s) const { src_delete(s); }
+};
+
+using SrcPtr_ = std::unique_ptr<SRC_STATE, SrcDeleter_>;
+
+/* states_
+All the states ever allocated, owned by the pool. */
+
+std::vector<SrcPtr_> states_;
+
+/* free_, assigned_
+States not yet given to any channel, and the ones in use keyed by channel ID. */
+
+std::vector<SRC_STATE*>            free_;
+std::unordered_map<ID, SRC_STATE*> assigned_;
+
+/* -------------------------------------------------------------------------- */
+
+SRC_STATE* allocate_()
+{
+	SRC_STATE* s = src_new(SRC_LINEAR, G_MAX_IO_CHANS, nullptr);
+	if (s == nullptr)
+	{
+		u::log::print("[resamplerPool] unable to allocate memory for SRC_STATE!\n");
+		throw std::bad_alloc();
+	}
+	states_.push_back(SrcPtr_(s));
+	return s;
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void init(int size)
+{
+	releaseAll();
+
+	states_.reserve(size);
+	free_.reserve(size);
+	while (static_cast<int>(states_.size()) < size)
+		free_.push_back(allocate_());
+}
+
+/* -------------------------------------------------------------------------- */
+
+SRC_STATE* get(ID channelId)
+{
+	if (auto it = assigned_.find(channelId); it != assigned_.end())
+		return it->second;
+
+	SRC_STATE* s;
+	if (free_.empty())
+		s = allocate_();
+	else
+	{
+		s = free_.back();
+		free_.pop_back();
+	}
+
+	assigned_[channelId] = s;
+	return s;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void release(ID channelId)
+{
+	auto it = assigned_.find(channelId);
+	if (it == assigned_.end())
+		return;
+
+	src_reset(it->second);
+	free_.push_back(it->second);
+	assigned_.erase(it);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void releaseAll()
+{
+	for (auto& [id, s] : assigned_)
+	{
+		src_reset(s);
+		free_.push_back(s);
+	}
+	assigned_.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+int countFree()
+{
+	return static_cast<int>(free_.size());
+}
+} // namespace giada::m::resamplerPool
@@ -0,0 +1,71 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_RESAMPLER_POOL_H
+#define G_RESAMPLER_POOL_H
+
+#include "core/types.h"
+#include <samplerate.h>
+
+/* resamplerPool
+A pool of preallocated libsamplerate states, one per channel. Channels borrow
+their state from here instead of owning it, so that copying a channel (e.g. 
+when the model is swapped) never calls into libsamplerate nor allocates. All
+functions here must be called by the non-realtime thread. */
+
+namespace giada::m::resamplerPool
+{
+/* init
+Preallocates 'size' states. All states currently assigned to channels are 
+taken back: call it only when no channel is being processed. */
+
+void init(int size);
+
+/* get
+Returns the state assigned to channel 'channelId', assigning a free one on the 
+first call. The pool grows if there are no free states left. Throws 
+std::bad_alloc if libsamplerate fails to allocate a new state. */
+
+SRC_STATE* get(ID channelId);
+
+/* release
+Puts the state assigned to channel 'channelId' back in the pool. Call it when 
+the channel is no longer visible to the realtime thread. */
+
+void release(ID channelId);
+
+/* releaseAll
+Puts all assigned states back in the pool. Same constraints as init(). */
+
+void releaseAll();
+
+/* countFree
+Returns the number of states available for new channels. */
+
+int countFree();
+} // namespace giada::m::resamplerPool
+
+#endif
@@ -27,6 +27,7 @@
 #ifndef G_RING_BUFFER_H
 #define G_RING_BUFFER_H
 
+#include <algorithm>
 #include <array>
 
 namespace giada
@@ -60,7 +61,7 @@ public:
 	{
 		m_data[m_index] = t;
 		m_index         = (m_index + 1) % m_data.size(); // Wraps around at m_data.size()
-		m_end           = std::max(m_index, m_end);      // Points to the greater index
+		m_end           = std::min(m_end + 1, S);        // Grows up to S, then stays there
 	}
 
 	std::size_t size() const noexcept
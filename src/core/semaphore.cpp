@@ -0,0 +1,104 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "semaphore.h"
+#ifdef G_OS_WINDOWS
+#include <windows.h>
+#endif
+#include <cerrno>
+#include <climits>
+
+namespace giada
+{
+#if defined(G_OS_WINDOWS)
+
+Semaphore::Semaphore()
+: m_handle(CreateSemaphore(nullptr, 0, LONG_MAX, nullptr))
+{
+}
+
+Semaphore::~Semaphore()
+{
+	CloseHandle(m_handle);
+}
+
+void Semaphore::post()
+{
+	ReleaseSemaphore(m_handle, 1, nullptr);
+}
+
+void Semaphore::wait()
+{
+	WaitForSingleObject(m_handle, INFINITE);
+}
+
+#elif defined(G_OS_MAC)
+
+Semaphore::Semaphore()
+: m_handle(dispatch_semaphore_create(0))
+{
+}
+
+Semaphore::~Semaphore()
+{
+	dispatch_release(m_handle);
+}
+
+void Semaphore::post()
+{
+	dispatch_semaphore_signal(m_handle);
+}
+
+void Semaphore::wait()
+{
+	dispatch_semaphore_wait(m_handle, DISPATCH_TIME_FOREVER);
+}
+
+#else
+
+Semaphore::Semaphore()
+{
+	sem_init(&m_handle, /*pshared=*/0, /*value=*/0);
+}
+
+Semaphore::~Semaphore()
+{
+	sem_destroy(&m_handle);
+}
+
+void Semaphore::post()
+{
+	sem_post(&m_handle);
+}
+
+void Semaphore::wait()
+{
+	while (sem_wait(&m_handle) == -1 && errno == EINTR) // Interrupted by a signal
+		;
+}
+
+#endif
+} // namespace giada
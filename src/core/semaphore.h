@@ -0,0 +1,71 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_SEMAPHORE_H
+#define G_SEMAPHORE_H
+
+#include "core/const.h"
+#if defined(G_OS_MAC)
+#include <dispatch/dispatch.h>
+#elif !defined(G_OS_WINDOWS)
+#include <semaphore.h>
+#endif
+
+namespace giada
+{
+/* Semaphore
+A counting semaphore backed by the OS. post() never blocks nor takes a lock, so
+it can be called from the audio thread to wake up another thread. */
+
+class Semaphore
+{
+public:
+	Semaphore();
+	Semaphore(const Semaphore&) = delete;
+	~Semaphore();
+
+	/* post
+	[realtime] Increments the count, waking up a thread blocked in wait(). */
+
+	void post();
+
+	/* wait
+	Blocks until the count is greater than zero, then decrements it. */
+
+	void wait();
+
+private:
+#if defined(G_OS_WINDOWS)
+	void* m_handle; // HANDLE, without pulling in windows.h
+#elif defined(G_OS_MAC)
+	dispatch_semaphore_t m_handle;
+#else
+	sem_t m_handle;
+#endif
+};
+} // namespace giada
+
+#endif
@@ -34,6 +34,7 @@
 #include "core/model/model.h"
 #include "core/quantizer.h"
 #include "core/recManager.h"
+#include <algorithm>
 
 namespace giada::m::sequencer
 {
@@ -49,12 +50,41 @@ EventBuffer eventBuffer_;
 
 Metronome metronome_;
 
+/* cursor_, cursorFrame_, cursorVersion_
+Playback cursor in the action Timeline: index of the first entry not parsed
+yet, the frame it has been computed for and the Timeline version it refers 
+to. Saves a search in the Timeline when blocks are parsed in sequence. */
+
+std::size_t cursor_        = 0;
+Frame       cursorFrame_   = -1;
+int         cursorVersion_ = -1;
+
+/* blockSize_, blockSpan_
+Size of the current block and number of sequencer frames it covers. They 
+differ while the playhead is nudged, see clock::takeNudge(). */
+
+Frame blockSize_ = 0;
+Frame blockSpan_ = 0;
+
+/* -------------------------------------------------------------------------- */
+
+/* toDelta_
+Converts an offset within the sequencer frames covered by the current block to
+an offset within the block. */
+
+Frame toDelta_(Frame offset)
+{
+	if (blockSpan_ == blockSize_)
+		return offset;
+	return std::min(offset * blockSize_ / blockSpan_, blockSize_ - 1);
+}
+
 /* -------------------------------------------------------------------------- */
 
 void rewindQ_(Frame delta)
 {
 	clock::rewind();
-	eventBuffer_.push_back({EventType::REWIND, 0, delta});
+	eventBuffer_.push_back({EventType::REWIND, 0, toDelta_(delta)});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -92,6 +122,87 @@ void rewind_()
 #endif
 		rewind();
 }
+
+/* -------------------------------------------------------------------------- */
+
+/* seek_
+Returns the index of the first Timeline entry at or after frame 'f'. */
+
+std::size_t seek_(const recorder::Timeline& timeline, Frame f)
+{
+	if (timeline.version == cursorVersion_ && f == cursorFrame_)
+		return cursor_;
+	auto it = std::lower_bound(timeline.frames.begin(), timeline.frames.end(), f);
+	return it - timeline.frames.begin();
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* parseRange_
+Generates events for global frames in range [from, to), which must not cross
+the loop boundary. 'local' is the offset of 'from' in the current block. Beats
+and bars are computed arithmetically, actions are read from the Timeline: the 
+cost depends on the number of events, not on the range size. */
+
+void parseRange_(Frame from, Frame to, Frame local, bool withActions)
+{
+	const Frame framesInBar  = clock::getFramesInBar();
+	const Frame framesInBeat = clock::getFramesInBeat();
+
+	const recorder::Timeline& timeline = recorder::getTimeline();
+	const std::size_t         size     = withActions ? timeline.frames.size() : 0;
+
+	/* Beats and bars have their own cursors: frames in bar and frames in beat
+	are truncated independently, so the former is not necessarily a multiple
+	of the latter. */
+
+	std::size_t next = withActions ? seek_(timeline, from) : 0;
+	Frame       beat = ((from + framesInBeat - 1) / framesInBeat) * framesInBeat;
+	Frame       bar  = ((from + framesInBar - 1) / framesInBar) * framesInBar;
+
+	while (true)
+	{
+		const Frame action = next < size && timeline.frames[next] < to ? timeline.frames[next] : to;
+		const Frame grid   = std::min(beat, bar);
+
+		/* Beats and bars come before actions on the same frame. */
+
+		if (grid < to && grid <= action)
+		{
+			const Frame delta = toDelta_(local + grid - from);
+			if (grid == 0)
+			{
+				eventBuffer_.push_back({EventType::FIRST_BEAT, grid, delta});
+				metronome_.trigger(Metronome::Click::BEAT, delta);
+			}
+			else if (grid == bar)
+			{
+				eventBuffer_.push_back({EventType::BAR, grid, delta});
+				metronome_.trigger(Metronome::Click::BAR, delta);
+			}
+			else
+				metronome_.trigger(Metronome::Click::BEAT, delta);
+			if (grid == beat)
+				beat += framesInBeat;
+			if (grid == bar)
+				bar += framesInBar;
+		}
+		else if (action < to)
+		{
+			eventBuffer_.push_back({EventType::ACTIONS, action, toDelta_(local + action - from), timeline.actions[next]});
+			next++;
+		}
+		else
+			break;
+	}
+
+	if (withActions)
+	{
+		cursor_        = next;
+		cursorFrame_   = to;
+		cursorVersion_ = timeline.version;
+	}
+}
 } // namespace
 
 /* -------------------------------------------------------------------------- */
@@ -134,43 +245,36 @@ void react(const eventDispatcher::EventBuffer& events)
 
 /* -------------------------------------------------------------------------- */
 
-const EventBuffer& advance(Frame bufferSize)
+const EventBuffer& advance(Frame bufferSize, bool withActions)
 {
 	eventBuffer_.clear();
 
-	const Frame start        = clock::getCurrentFrame();
-	const Frame end          = start + bufferSize;
-	const Frame framesInLoop = clock::getFramesInLoop();
-	const Frame framesInBar  = clock::getFramesInBar();
-	const Frame framesInBeat = clock::getFramesInBeat();
+	/* While following an external clock the block might cover a few sequencer
+	frames more or less than its size, to keep the phase in sync. */
 
-	for (Frame i = start, local = 0; i < end; i++, local++)
-	{
+	blockSize_ = bufferSize;
+	blockSpan_ = bufferSize + clock::takeNudge(bufferSize);
 
-		Frame global = i % framesInLoop; // wraps around 'framesInLoop'
+	const Frame start        = clock::getCurrentFrame();
+	const Frame end          = start + blockSpan_;
+	const Frame framesInLoop = clock::getFramesInLoop();
 
-		if (global == 0)
-		{
-			eventBuffer_.push_back({EventType::FIRST_BEAT, global, local});
-			metronome_.trigger(Metronome::Click::BEAT, local);
-		}
-		else if (global % framesInBar == 0)
-		{
-			eventBuffer_.push_back({EventType::BAR, global, local});
-			metronome_.trigger(Metronome::Click::BAR, local);
-		}
-		else if (global % framesInBeat == 0)
-		{
-			metronome_.trigger(Metronome::Click::BEAT, local);
-		}
+	/* Split the block in two ranges if it crosses the loop boundary. */
 
-		const std::vector<Action>* as = recorder::getActionsOnFrame(global);
-		if (as != nullptr)
-			eventBuffer_.push_back({EventType::ACTIONS, global, local, as});
+	Frame global = start % framesInLoop;
+	Frame local  = 0;
+	while (local < blockSpan_)
+	{
+		const Frame count = std::min(blockSpan_ - local, framesInLoop - global);
+		parseRange_(global, global + count, local, withActions);
+		local += count;
+		global = 0;
 	}
 
-	/* Advance clock and quantizer after the event parsing. */
-	clock::advance(bufferSize);
+	/* Generate MIDI sync for this block, then advance clock and quantizer 
+	after the event parsing. */
+	clock::sendMIDIsync(bufferSize);
+	clock::advance(blockSpan_);
 	quantizer.advance(Range<Frame>(start, end), clock::getQuantizerStep());
 
 	return eventBuffer_;
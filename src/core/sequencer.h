@@ -27,6 +27,7 @@
 #ifndef G_SEQUENCER_H
 #define G_SEQUENCER_H
 
+#include "core/actionTable.h"
 #include "core/eventDispatcher.h"
 #include "core/quantizer.h"
 #include <vector>
@@ -48,10 +49,10 @@ enum class EventType
 
 struct Event
 {
-	EventType                  type    = EventType::NONE;
-	Frame                      global  = 0;
-	Frame                      delta   = 0;
-	const std::vector<Action>* actions = nullptr;
+	EventType         type   = EventType::NONE;
+	Frame             global = 0;
+	Frame             delta  = 0;
+	ActionTable::View actions = {};
 };
 
 using EventBuffer = RingBuffer<Event, G_MAX_SEQUENCER_EVENTS>;
@@ -71,9 +72,11 @@ void react(const eventDispatcher::EventBuffer& e);
 /* advance
 Parses sequencer events that might occur in a block and advances the internal 
 quantizer. Returns a reference to the internal EventBuffer filled with events
-(if any). Call this on each new audio block. */
+(if any). Call this on each new audio block. Recorded actions are skipped if
+'withActions' is false, i.e. when the model is locked and the recorder might be
+changing them. */
 
-const EventBuffer& advance(Frame bufferSize);
+const EventBuffer& advance(Frame bufferSize, bool withActions = true);
 
 /* render
 Renders audio coming out from the sequencer: that is, the metronome! */
@@ -0,0 +1,732 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/simd.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define G_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+/* AVX2 kernels are compiled with a per-function target attribute and picked at
+runtime, so that the rest of the binary still runs on any x86 CPU. Only 
+available on GCC and Clang for now. */
+
+#if defined(G_SIMD_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define G_SIMD_AVX2
+#define G_SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define G_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace giada::m::simd
+{
+namespace
+{
+/* Scalar reference implementation. Vector kernels below fall back to these for
+the trailing samples that don't fill a whole register. All of them must give 
+the same results. */
+
+template <bool SUM>
+void copyScalar_(float* dest, const float* src, int samples, float gain, float panL, float panR)
+{
+	const float pan[2] = {panL, panR};
+	for (int i = 0; i < samples; i++)
+	{
+		const float v = src[i] * gain * pan[i % 2];
+		if constexpr (SUM)
+			dest[i] += v;
+		else
+			dest[i] = v;
+	}
+}
+
+template <bool SUM>
+void copyMonoToStereoScalar_(float* dest, const float* src, int frames, float gain, float panL, float panR)
+{
+	for (int i = 0; i < frames; i++)
+	{
+		const float l = src[i] * gain * panL;
+		const float r = src[i] * gain * panR;
+		if constexpr (SUM)
+		{
+			dest[i * 2] += l;
+			dest[i * 2 + 1] += r;
+		}
+		else
+		{
+			dest[i * 2]     = l;
+			dest[i * 2 + 1] = r;
+		}
+	}
+}
+
+void applyGainScalar_(float* dest, int samples, float gain)
+{
+	for (int i = 0; i < samples; i++)
+		dest[i] *= gain;
+}
+
+void applyRampScalar_(float* dest, int samples, int channels, float gain, float step)
+{
+	for (int i = 0; i < samples; i++)
+		dest[i] *= gain + step * (i / channels);
+}
+
+void clampScalar_(float* dest, int samples, float min, float max)
+{
+	for (int i = 0; i < samples; i++)
+		dest[i] = std::max(min, std::min(dest[i], max));
+}
+
+float maxScalar_(const float* src, int samples, float peak)
+{
+	for (int i = 0; i < samples; i++)
+		peak = std::max(peak, src[i]);
+	return peak;
+}
+
+float getPeakScalar_(const float* src, int samples)
+{
+	return maxScalar_(src, samples, 0.0f);
+}
+
+template <bool IN_TO_OUT, bool LIMIT>
+void finalizeScalar_(float* dest, const float* in, int samples, float gain,
+    float& peak, float& sumSquares)
+{
+	for (int i = 0; i < samples; i++)
+	{
+		float v;
+		if constexpr (IN_TO_OUT)
+			v = dest[i] + in[i] * gain;
+		else
+			v = dest[i] * gain;
+		if constexpr (LIMIT)
+			v = std::max(-1.0f, std::min(v, 1.0f));
+		dest[i] = v;
+		peak    = std::max(peak, v);
+		sumSquares += v * v;
+	}
+}
+
+template <bool IN_TO_OUT, bool LIMIT>
+Levels finalizeScalar_(float* dest, const float* in, int samples, float gain)
+{
+	float peak       = 0.0f;
+	float sumSquares = 0.0f;
+	finalizeScalar_<IN_TO_OUT, LIMIT>(dest, in, samples, gain, peak, sumSquares);
+	return {peak, samples > 0 ? std::sqrt(sumSquares / samples) : 0.0f};
+}
+
+/* selectFinalize_
+Turns the four compile-time variants of a finalize kernel into a single one. */
+
+using FinalizeFn = Levels (*)(float*, const float*, int, float);
+
+template <FinalizeFn IN_LIMIT, FinalizeFn IN, FinalizeFn LIMIT, FinalizeFn NONE>
+Levels selectFinalize_(float* dest, const float* in, int samples, float gain, bool limit)
+{
+	if (in != nullptr)
+		return limit ? IN_LIMIT(dest, in, samples, gain) : IN(dest, in, samples, gain);
+	return limit ? LIMIT(dest, in, samples, gain) : NONE(dest, in, samples, gain);
+}
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef G_SIMD_SSE2
+
+template <bool SUM>
+void copySSE2_(float* dest, const float* src, int samples, float gain, float panL, float panR)
+{
+	const __m128 g = _mm_set1_ps(gain);
+	const __m128 p = _mm_setr_ps(panL, panR, panL, panR);
+
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+	{
+		__m128 v = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(src + i), g), p);
+		if constexpr (SUM)
+			v = _mm_add_ps(_mm_loadu_ps(dest + i), v);
+		_mm_storeu_ps(dest + i, v);
+	}
+	copyScalar_<SUM>(dest + i, src + i, samples - i, gain, panL, panR);
+}
+
+template <bool SUM>
+void copyMonoToStereoSSE2_(float* dest, const float* src, int frames, float gain, float panL, float panR)
+{
+	const __m128 g = _mm_set1_ps(gain);
+	const __m128 p = _mm_setr_ps(panL, panR, panL, panR);
+
+	int i = 0;
+	for (; i + 4 <= frames; i += 4)
+	{
+		const __m128 v  = _mm_mul_ps(_mm_loadu_ps(src + i), g);
+		__m128       lo = _mm_mul_ps(_mm_unpacklo_ps(v, v), p); // 0 0 1 1
+		__m128       hi = _mm_mul_ps(_mm_unpackhi_ps(v, v), p); // 2 2 3 3
+		if constexpr (SUM)
+		{
+			lo = _mm_add_ps(_mm_loadu_ps(dest + i * 2), lo);
+			hi = _mm_add_ps(_mm_loadu_ps(dest + i * 2 + 4), hi);
+		}
+		_mm_storeu_ps(dest + i * 2, lo);
+		_mm_storeu_ps(dest + i * 2 + 4, hi);
+	}
+	copyMonoToStereoScalar_<SUM>(dest + i * 2, src + i, frames - i, gain, panL, panR);
+}
+
+void applyGainSSE2_(float* dest, int samples, float gain)
+{
+	const __m128 g = _mm_set1_ps(gain);
+
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+		_mm_storeu_ps(dest + i, _mm_mul_ps(_mm_loadu_ps(dest + i), g));
+	applyGainScalar_(dest + i, samples - i, gain);
+}
+
+/* Vector ramps work on mono and stereo data, i.e. whole frames in each 
+register. The gain of each register is computed from its first frame rather 
+than accumulated, so that rounding errors don't add up along the block. */
+
+void applyRampSSE2_(float* dest, int samples, int channels, float gain, float step)
+{
+	if (channels != 1 && channels != 2)
+	{
+		applyRampScalar_(dest, samples, channels, gain, step);
+		return;
+	}
+
+	const int    frames = 4 / channels; // Frames per register
+	const __m128 lanes  = channels == 1 ? _mm_setr_ps(0, 1, 2, 3) : _mm_setr_ps(0, 0, 1, 1);
+	const __m128 s      = _mm_set1_ps(step);
+
+	int i = 0;
+	for (int f = 0; i + 4 <= samples; i += 4, f += frames)
+	{
+		const __m128 g = _mm_add_ps(_mm_set1_ps(gain + step * f), _mm_mul_ps(lanes, s));
+		_mm_storeu_ps(dest + i, _mm_mul_ps(_mm_loadu_ps(dest + i), g));
+	}
+	applyRampScalar_(dest + i, samples - i, channels, gain + step * (i / channels), step);
+}
+
+void clampSSE2_(float* dest, int samples, float min, float max)
+{
+	const __m128 vmin = _mm_set1_ps(min);
+	const __m128 vmax = _mm_set1_ps(max);
+
+	/* Operands order matters: it mimics std::min/std::max behavior. */
+
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+		_mm_storeu_ps(dest + i, _mm_max_ps(_mm_min_ps(vmax, _mm_loadu_ps(dest + i)), vmin));
+	clampScalar_(dest + i, samples - i, min, max);
+}
+
+float getPeakSSE2_(const float* src, int samples)
+{
+	__m128 peak = _mm_setzero_ps();
+
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+		peak = _mm_max_ps(_mm_loadu_ps(src + i), peak);
+
+	float lanes[4];
+	_mm_storeu_ps(lanes, peak);
+	return maxScalar_(src + i, samples - i, maxScalar_(lanes, 4, 0.0f));
+}
+
+template <bool IN_TO_OUT, bool LIMIT>
+Levels finalizeSSE2_(float* dest, const float* in, int samples, float gain)
+{
+	const __m128 g    = _mm_set1_ps(gain);
+	const __m128 vmin = _mm_set1_ps(-1.0f);
+	const __m128 vmax = _mm_set1_ps(1.0f);
+	__m128       peak = _mm_setzero_ps();
+	__m128       sum  = _mm_setzero_ps();
+
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+	{
+		__m128 v = _mm_loadu_ps(dest + i);
+		if constexpr (IN_TO_OUT)
+			v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(in + i), g));
+		else
+			v = _mm_mul_ps(v, g);
+		if constexpr (LIMIT)
+			v = _mm_max_ps(_mm_min_ps(vmax, v), vmin);
+		_mm_storeu_ps(dest + i, v);
+		peak = _mm_max_ps(v, peak);
+		sum  = _mm_add_ps(sum, _mm_mul_ps(v, v));
+	}
+
+	float peakLanes[4], sumLanes[4];
+	_mm_storeu_ps(peakLanes, peak);
+	_mm_storeu_ps(sumLanes, sum);
+
+	float outPeak = maxScalar_(peakLanes, 4, 0.0f);
+	float outSum  = sumLanes[0] + sumLanes[1] + sumLanes[2] + sumLanes[3];
+	finalizeScalar_<IN_TO_OUT, LIMIT>(dest + i, IN_TO_OUT ? in + i : nullptr, samples - i, gain, outPeak, outSum);
+	return {outPeak, samples > 0 ? std::sqrt(outSum / samples) : 0.0f};
+}
+
+#endif // #ifdef G_SIMD_SSE2
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef G_SIMD_AVX2
+
+template <bool SUM>
+G_SIMD_TARGET_AVX2 void copyAVX2_(float* dest, const float* src, int samples, float gain, float panL, float panR)
+{
+	const __m256 g = _mm256_set1_ps(gain);
+	const __m256 p = _mm256_setr_ps(panL, panR, panL, panR, panL, panR, panL, panR);
+
+	int i = 0;
+	for (; i + 8 <= samples; i += 8)
+	{
+		__m256 v = _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), g), p);
+		if constexpr (SUM)
+			v = _mm256_add_ps(_mm256_loadu_ps(dest + i), v);
+		_mm256_storeu_ps(dest + i, v);
+	}
+	copyScalar_<SUM>(dest + i, src + i, samples - i, gain, panL, panR);
+}
+
+template <bool SUM>
+G_SIMD_TARGET_AVX2 void copyMonoToStereoAVX2_(float* dest, const float* src, int frames, float gain, float panL, float panR)
+{
+	const __m256 g = _mm256_set1_ps(gain);
+	const __m256 p = _mm256_setr_ps(panL, panR, panL, panR, panL, panR, panL, panR);
+
+	int i = 0;
+	for (; i + 8 <= frames; i += 8)
+	{
+		const __m256 v  = _mm256_mul_ps(_mm256_loadu_ps(src + i), g);
+		const __m256 ul = _mm256_unpacklo_ps(v, v); // 0 0 1 1 | 4 4 5 5
+		const __m256 uh = _mm256_unpackhi_ps(v, v); // 2 2 3 3 | 6 6 7 7
+		__m256       lo = _mm256_mul_ps(_mm256_permute2f128_ps(ul, uh, 0x20), p);
+		__m256       hi = _mm256_mul_ps(_mm256_permute2f128_ps(ul, uh, 0x31), p);
+		if constexpr (SUM)
+		{
+			lo = _mm256_add_ps(_mm256_loadu_ps(dest + i * 2), lo);
+			hi = _mm256_add_ps(_mm256_loadu_ps(dest + i * 2 + 8), hi);
+		}
+		_mm256_storeu_ps(dest + i * 2, lo);
+		_mm256_storeu_ps(dest + i * 2 + 8, hi);
+	}
+	copyMonoToStereoScalar_<SUM>(dest + i * 2, src + i, frames - i, gain, panL, panR);
+}
+
+G_SIMD_TARGET_AVX2 void applyGainAVX2_(float* dest, int samples, float gain)
+{
+	const __m256 g = _mm256_set1_ps(gain);
+
+	int i = 0;
+	for (; i + 8 <= samples; i += 8)
+		_mm256_storeu_ps(dest + i, _mm256_mul_ps(_mm256_loadu_ps(dest + i), g));
+	applyGainScalar_(dest + i, samples - i, gain);
+}
+
+G_SIMD_TARGET_AVX2 void applyRampAVX2_(float* dest, int samples, int channels, float gain, float step)
+{
+	if (channels != 1 && channels != 2)
+	{
+		applyRampScalar_(dest, samples, channels, gain, step);
+		return;
+	}
+
+	const int    frames = 8 / channels;
+	const __m256 lanes  = channels == 1 ? _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7) : _mm256_setr_ps(0, 0, 1, 1, 2, 2, 3, 3);
+	const __m256 s      = _mm256_set1_ps(step);
+
+	int i = 0;
+	for (int f = 0; i + 8 <= samples; i += 8, f += frames)
+	{
+		const __m256 g = _mm256_add_ps(_mm256_set1_ps(gain + step * f), _mm256_mul_ps(lanes, s));
+		_mm256_storeu_ps(dest + i, _mm256_mul_ps(_mm256_loadu_ps(dest + i), g));
+	}
+	applyRampScalar_(dest + i, samples - i, channels, gain + step * (i / channels), step);
+}
+
+G_SIMD_TARGET_AVX2 void clampAVX2_(float* dest, int samples, float min, float max)
+{
+	const __m256 vmin = _mm256_set1_ps(min);
+	const __m256 vmax = _mm256_set1_ps(max);
+
+	int i = 0;
+	for (; i + 8 <= samples; i += 8)
+		_mm256_storeu_ps(dest + i, _mm256_max_ps(_mm256_min_ps(vmax, _mm256_loadu_ps(dest + i)), vmin));
+	clampScalar_(dest + i, samples - i, min, max);
+}
+
+G_SIMD_TARGET_AVX2 float getPeakAVX2_(const float* src, int samples)
+{
+	__m256 peak = _mm256_setzero_ps();
+
+	int i = 0;
+	for (; i + 8 <= samples; i += 8)
+		peak = _mm256_max_ps(_mm256_loadu_ps(src + i), peak);
+
+	float lanes[8];
+	_mm256_storeu_ps(lanes, peak);
+	return maxScalar_(src + i, samples - i, maxScalar_(lanes, 8, 0.0f));
+}
+
+template <bool IN_TO_OUT, bool LIMIT>
+G_SIMD_TARGET_AVX2 Levels finalizeAVX2_(float* dest, const float* in, int samples, float gain)
+{
+	const __m256 g    = _mm256_set1_ps(gain);
+	const __m256 vmin = _mm256_set1_ps(-1.0f);
+	const __m256 vmax = _mm256_set1_ps(1.0f);
+	__m256       peak = _mm256_setzero_ps();
+	__m256       sum  = _mm256_setzero_ps();
+
+	int i = 0;
+	for (; i + 8 <= samples; i += 8)
+	{
+		__m256 v = _mm256_loadu_ps(dest + i);
+		if constexpr (IN_TO_OUT)
+			v = _mm256_add_ps(v, _mm256_mul_ps(_mm256_loadu_ps(in + i), g));
+		else
+			v = _mm256_mul_ps(v, g);
+		if constexpr (LIMIT)
+			v = _mm256_max_ps(_mm256_min_ps(vmax, v), vmin);
+		_mm256_storeu_ps(dest + i, v);
+		peak = _mm256_max_ps(v, peak);
+		sum  = _mm256_add_ps(sum, _mm256_mul_ps(v, v));
+	}
+
+	float peakLanes[8], sumLanes[8];
+	_mm256_storeu_ps(peakLanes, peak);
+	_mm256_storeu_ps(sumLanes, sum);
+
+	float outPeak = maxScalar_(peakLanes, 8, 0.0f);
+	float outSum  = 0.0f;
+	for (float s : sumLanes)
+		outSum += s;
+	finalizeScalar_<IN_TO_OUT, LIMIT>(dest + i, IN_TO_OUT ? in + i : nullptr, samples - i, gain, outPeak, outSum);
+	return {outPeak, samples > 0 ? std::sqrt(outSum / samples) : 0.0f};
+}
+
+#endif // #ifdef G_SIMD_AVX2
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef G_SIMD_NEON
+
+template <bool SUM>
+void copyNEON_(float* dest, const float* src, int samples, float gain, float panL, float panR)
+{
+	const float       pan[4] = {panL, panR, panL, panR};
+	const float32x4_t g      = vdupq_n_f32(gain);
+	const float32x4_t p      = vld1q_f32(pan);
+
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+	{
+		float32x4_t v = vmulq_f32(vmulq_f32(vld1q_f32(src + i), g), p);
+		if constexpr (SUM)
+			v = vaddq_f32(vld1q_f32(dest + i), v);
+		vst1q_f32(dest + i, v);
+	}
+	copyScalar_<SUM>(dest + i, src + i, samples - i, gain, panL, panR);
+}
+
+template <bool SUM>
+void copyMonoToStereoNEON_(float* dest, const float* src, int frames, float gain, float panL, float panR)
+{
+	const float       pan[4] = {panL, panR, panL, panR};
+	const float32x4_t g      = vdupq_n_f32(gain);
+	const float32x4_t p      = vld1q_f32(pan);
+
+	int i = 0;
+	for (; i + 4 <= frames; i += 4)
+	{
+		const float32x4_t   v  = vmulq_f32(vld1q_f32(src + i), g);
+		const float32x4x2_t z  = vzipq_f32(v, v); // 0 0 1 1, 2 2 3 3
+		float32x4_t         lo = vmulq_f32(z.val[0], p);
+		float32x4_t         hi = vmulq_f32(z.val[1], p);
+		if constexpr (SUM)
+		{
+			lo = vaddq_f32(vld1q_f32(dest + i * 2), lo);
+			hi = vaddq_f32(vld1q_f32(dest + i * 2 + 4), hi);
+		}
+		vst1q_f32(dest + i * 2, lo);
+		vst1q_f32(dest + i * 2 + 4, hi);
+	}
+	copyMonoToStereoScalar_<SUM>(dest + i * 2, src + i, frames - i, gain, panL, panR);
+}
+
+void applyGainNEON_(float* dest, int samples, float gain)
+{
+	const float32x4_t g = vdupq_n_f32(gain);
+
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+		vst1q_f32(dest + i, vmulq_f32(vld1q_f32(dest + i), g));
+	applyGainScalar_(dest + i, samples - i, gain);
+}
+
+void applyRampNEON_(float* dest, int samples, int channels, float gain, float step)
+{
+	if (channels != 1 && channels != 2)
+	{
+		applyRampScalar_(dest, samples, channels, gain, step);
+		return;
+	}
+
+	const float       mono[4]   = {0, 1, 2, 3};
+	const float       stereo[4] = {0, 0, 1, 1};
+	const int         frames    = 4 / channels;
+	const float32x4_t lanes     = vld1q_f32(channels == 1 ? mono : stereo);
+	const float32x4_t s         = vdupq_n_f32(step);
+
+	int i = 0;
+	for (int f = 0; i + 4 <= samples; i += 4, f += frames)
+	{
+		const float32x4_t g = vaddq_f32(vdupq_n_f32(gain + step * f), vmulq_f32(lanes, s));
+		vst1q_f32(dest + i, vmulq_f32(vld1q_f32(dest + i), g));
+	}
+	applyRampScalar_(dest + i, samples - i, channels, gain + step * (i / channels), step);
+}
+
+void clampNEON_(float* dest, int samples, float min, float max)
+{
+	const float32x4_t vmin = vdupq_n_f32(min);
+	const float32x4_t vmax = vdupq_n_f32(max);
+
+	/* Compare and select rather than vminq/vmaxq, which propagate NaNs
+	differently than std::min/std::max. */
+
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+	{
+		float32x4_t v = vld1q_f32(dest + i);
+		v             = vbslq_f32(vcltq_f32(vmax, v), vmax, v);
+		v             = vbslq_f32(vcltq_f32(vmin, v), v, vmin);
+		vst1q_f32(dest + i, v);
+	}
+	clampScalar_(dest + i, samples - i, min, max);
+}
+
+float getPeakNEON_(const float* src, int samples)
+{
+	float32x4_t peak = vdupq_n_f32(0.0f);
+
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+	{
+		const float32x4_t v = vld1q_f32(src + i);
+		peak                = vbslq_f32(vcgtq_f32(v, peak), v, peak);
+	}
+
+	float lanes[4];
+	vst1q_f32(lanes, peak);
+	return maxScalar_(src + i, samples - i, maxScalar_(lanes, 4, 0.0f));
+}
+
+template <bool IN_TO_OUT, bool LIMIT>
+Levels finalizeNEON_(float* dest, const float* in, int samples, float gain)
+{
+	const float32x4_t g    = vdupq_n_f32(gain);
+	const float32x4_t vmin = vdupq_n_f32(-1.0f);
+	const float32x4_t vmax = vdupq_n_f32(1.0f);
+	float32x4_t       peak = vdupq_n_f32(0.0f);
+	float32x4_t       sum  = vdupq_n_f32(0.0f);
+
+	int i = 0;
+	for (; i + 4 <= samples; i += 4)
+	{
+		float32x4_t v = vld1q_f32(dest + i);
+		if constexpr (IN_TO_OUT)
+			v = vaddq_f32(v, vmulq_f32(vld1q_f32(in + i), g));
+		else
+			v = vmulq_f32(v, g);
+		if constexpr (LIMIT)
+		{
+			v = vbslq_f32(vcltq_f32(vmax, v), vmax, v);
+			v = vbslq_f32(vcltq_f32(vmin, v), v, vmin);
+		}
+		vst1q_f32(dest + i, v);
+		peak = vbslq_f32(vcgtq_f32(v, peak), v, peak);
+		sum  = vaddq_f32(sum, vmulq_f32(v, v));
+	}
+
+	float peakLanes[4], sumLanes[4];
+	vst1q_f32(peakLanes, peak);
+	vst1q_f32(sumLanes, sum);
+
+	float outPeak = maxScalar_(peakLanes, 4, 0.0f);
+	float outSum  = sumLanes[0] + sumLanes[1] + sumLanes[2] + sumLanes[3];
+	finalizeScalar_<IN_TO_OUT, LIMIT>(dest + i, IN_TO_OUT ? in + i : nullptr, samples - i, gain, outPeak, outSum);
+	return {outPeak, samples > 0 ? std::sqrt(outSum / samples) : 0.0f};
+}
+
+#endif // #ifdef G_SIMD_NEON
+
+/* -------------------------------------------------------------------------- */
+
+constexpr Kernels scalar_ = {
+    Instructions::NONE,
+    copyScalar_<false>,
+    copyScalar_<true>,
+    copyMonoToStereoScalar_<false>,
+    copyMonoToStereoScalar_<true>,
+    applyGainScalar_,
+    applyRampScalar_,
+    clampScalar_,
+    getPeakScalar_,
+    selectFinalize_<finalizeScalar_<true, true>, finalizeScalar_<true, false>,
+        finalizeScalar_<false, true>, finalizeScalar_<false, false>>};
+
+#ifdef G_SIMD_SSE2
+constexpr Kernels sse2_ = {
+    Instructions::SSE2,
+    copySSE2_<false>,
+    copySSE2_<true>,
+    copyMonoToStereoSSE2_<false>,
+    copyMonoToStereoSSE2_<true>,
+    applyGainSSE2_,
+    applyRampSSE2_,
+    clampSSE2_,
+    getPeakSSE2_,
+    selectFinalize_<finalizeSSE2_<true, true>, finalizeSSE2_<true, false>,
+        finalizeSSE2_<false, true>, finalizeSSE2_<false, false>>};
+#endif
+
+#ifdef G_SIMD_AVX2
+constexpr Kernels avx2_ = {
+    Instructions::AVX2,
+    copyAVX2_<false>,
+    copyAVX2_<true>,
+    copyMonoToStereoAVX2_<false>,
+    copyMonoToStereoAVX2_<true>,
+    applyGainAVX2_,
+    applyRampAVX2_,
+    clampAVX2_,
+    getPeakAVX2_,
+    selectFinalize_<finalizeAVX2_<true, true>, finalizeAVX2_<true, false>,
+        finalizeAVX2_<false, true>, finalizeAVX2_<false, false>>};
+#endif
+
+#ifdef G_SIMD_NEON
+constexpr Kernels neon_ = {
+    Instructions::NEON,
+    copyNEON_<false>,
+    copyNEON_<true>,
+    copyMonoToStereoNEON_<false>,
+    copyMonoToStereoNEON_<true>,
+    applyGainNEON_,
+    applyRampNEON_,
+    clampNEON_,
+    getPeakNEON_,
+    selectFinalize_<finalizeNEON_<true, true>, finalizeNEON_<true, false>,
+        finalizeNEON_<false, true>, finalizeNEON_<false, false>>};
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+bool hasAVX2_()
+{
+#ifdef G_SIMD_AVX2
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* best_
+Kernels returned by get(), resolved by init(). Scalar until then. */
+
+const Kernels* best_ = &scalar_;
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+std::vector<Instructions> getAvailable()
+{
+	std::vector<Instructions> out = {Instructions::NONE};
+#ifdef G_SIMD_SSE2
+	out.push_back(Instructions::SSE2);
+#endif
+	if (hasAVX2_())
+		out.push_back(Instructions::AVX2);
+#ifdef G_SIMD_NEON
+	out.push_back(Instructions::NEON);
+#endif
+	return out;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void init()
+{
+	best_ = &get(getAvailable().back());
+}
+
+/* -------------------------------------------------------------------------- */
+
+const Kernels& get()
+{
+	return *best_;
+}
+
+/* -------------------------------------------------------------------------- */
+
+const Kernels& get(Instructions i)
+{
+	switch (i)
+	{
+#ifdef G_SIMD_SSE2
+	case Instructions::SSE2:
+		return sse2_;
+#endif
+#ifdef G_SIMD_AVX2
+	case Instructions::AVX2:
+		return avx2_;
+#endif
+#ifdef G_SIMD_NEON
+	case Instructions::NEON:
+		return neon_;
+#endif
+	default:
+		return scalar_;
+	}
+}
+} // namespace giada::m::simd
@@ -0,0 +1,132 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2021 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_SIMD_H
+#define G_SIMD_H
+
+#include <vector>
+
+namespace giada::m::simd
+{
+/* Instructions
+Instruction sets the audio kernels can be built with. NONE is the plain scalar
+implementation, which is always available and acts as the reference for all 
+the others. */
+
+enum class Instructions
+{
+	NONE,
+	SSE2,
+	AVX2,
+	NEON
+};
+
+/* Levels
+Peak and RMS levels of a buffer. */
+
+struct Levels
+{
+	float peak = 0.0f;
+	float rms  = 0.0f;
+};
+
+/* Kernels
+A table of audio kernels working on raw float arrays. 'samples' is the number
+of floats to process; 'frames' is used by kernels that read mono data and 
+write interleaved stereo. Pan factors are applied on interleaved stereo data 
+as L, R, L, R, ... (pass the same value twice for mono). Arrays don't need to 
+be aligned. */
+
+struct Kernels
+{
+	Instructions instructions;
+
+	/* set, sum
+	dest[i] = src[i] * gain * pan[i % 2] (set), or dest[i] += ... (sum). */
+
+	void (*set)(float* dest, const float* src, int samples, float gain, float panL, float panR);
+	void (*sum)(float* dest, const float* src, int samples, float gain, float panL, float panR);
+
+	/* setMonoToStereo, sumMonoToStereo
+	Same as above, but spread a mono 'src' over an interleaved stereo 'dest'. */
+
+	void (*setMonoToStereo)(float* dest, const float* src, int frames, float gain, float panL, float panR);
+	void (*sumMonoToStereo)(float* dest, const float* src, int frames, float gain, float panL, float panR);
+
+	/* applyGain
+	dest[i] *= gain. */
+
+	void (*applyGain)(float* dest, int samples, float gain);
+
+	/* applyRamp
+	dest[i] *= gain + step * (i / channels), i.e. a linear gain ramp over 
+	interleaved data, changing by 'step' on each frame. */
+
+	void (*applyRamp)(float* dest, int samples, int channels, float gain, float step);
+
+	/* clamp
+	Clamps each sample to [min, max]. */
+
+	void (*clamp)(float* dest, int samples, float min, float max);
+
+	/* getPeak
+	Returns the highest value in 'src', or 0.0f if all values are negative. */
+
+	float (*getPeak)(const float* src, int samples);
+
+	/* finalize
+	Master bus stage, in a single pass: dest[i] += in[i] * gain if 'in' is not
+	null, dest[i] *= gain otherwise; then clamps to [-1.0, 1.0] if 'limit' is 
+	true. Returns the levels of the resulting 'dest' (peak as in getPeak). */
+
+	Levels (*finalize)(float* dest, const float* in, int samples, float gain, bool limit);
+};
+
+/* getAvailable
+Returns the instruction sets supported by the current CPU, NONE included. */
+
+std::vector<Instructions> getAvailable();
+
+/* init
+Picks the best instruction set for the current CPU. Call it once at startup,
+before the audio thread runs: it allocates. */
+
+void init();
+
+/* get (1)
+Returns the kernels picked by init(), or the scalar ones if init() hasn't been
+called yet. Safe to call from the audio thread. */
+
+const Kernels& get();
+
+/* get (2)
+Returns the kernels built with a specific instruction set. Useful for testing:
+the instruction set must be one of those returned by getAvailable(). */
+
+const Kernels& get(Instructions i);
+} // namespace giada::m::simd
+
+#endif
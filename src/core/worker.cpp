@@ -26,11 +26,13 @@
 
 #include "worker.h"
 #include "utils/time.h"
+#include <chrono>
 
 namespace giada
 {
 Worker::Worker()
 : m_running(false)
+, m_signalled(false)
 {
 }
 
@@ -57,9 +59,55 @@ void Worker::start(std::function<void()> f, int sleep)
 
 /* -------------------------------------------------------------------------- */
 
+void Worker::startSignalled(std::function<void()> f, int timeout, int coalesce)
+{
+	m_running.store(true);
+	m_thread = std::thread([this, f, timeout, coalesce]() {
+		while (m_running.load() == true)
+		{
+			bool signalled;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				signalled = m_cond.wait_for(lock, std::chrono::milliseconds(timeout), [this]() {
+					return !m_running.load() || m_signalled.load();
+				});
+			}
+			if (m_running.load() == false)
+				break;
+			if (signalled && coalesce > 0)
+				u::time::sleep(coalesce);
+
+			/* Clear the flag before running 'f': notifications coming in while
+			'f' is running will trigger another call. */
+
+			m_signalled.store(false);
+			f();
+		}
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Worker::notify()
+{
+	/* No lock here: this is called from the audio thread too. A notification
+	landing between the worker's check and its wait is lost, but the wait has
+	a timeout: the worker wakes up anyway, just a bit later. Skip the system 
+	call if a notification is already pending. */
+
+	if (!m_signalled.exchange(true))
+		m_cond.notify_one();
+}
+
+/* -------------------------------------------------------------------------- */
+
 void Worker::stop()
 {
-	m_running.store(false);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_running.store(false);
+	}
+	m_cond.notify_one();
 	if (m_thread.joinable())
 		m_thread.join();
 }
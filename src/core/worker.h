@@ -28,7 +28,9 @@
 #define G_WORKER_H
 
 #include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <mutex>
 #include <thread>
 
 namespace giada
@@ -39,12 +41,34 @@ public:
 	Worker();
 	~Worker();
 
+	/* start
+	Runs 'f' every 'sleep' milliseconds. */
+
 	void start(std::function<void()> f, int sleep);
+
+	/* startSignalled
+	Runs 'f' as soon as notify() is called, or every 'timeout' milliseconds if
+	nothing happens. If 'coalesce' > 0, waits that many milliseconds after a 
+	wakeup before running 'f', so that a burst of notifications is handled in a
+	single call. */
+
+	void startSignalled(std::function<void()> f, int timeout, int coalesce = 0);
+
+	/* notify
+	Wakes up a worker started with startSignalled(). Lock-free, can be called 
+	from the audio thread. In the rare case the wakeup is missed, the worker 
+	still runs on its next timeout. */
+
+	void notify();
+
 	void stop();
 
   private:
-	std::thread       m_thread;
-	std::atomic<bool> m_running;
+	std::thread             m_thread;
+	std::atomic<bool>       m_running;
+	std::atomic<bool>       m_signalled;
+	std::mutex              m_mutex;
+	std::condition_variable m_cond;
 };
 } // namespace giada
 
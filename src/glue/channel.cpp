@@ -61,6 +61,7 @@
 #include <cassert>
 #include <cmath>
 #include <functional>
+#include <utility>
 
 extern giada::v::gdMainWindow* G_MainWin;
 
@@ -158,7 +159,7 @@ Data getData(ID channelId)
 std::vector<Data> getChannels()
 {
 	std::vector<Data> out;
-	for (const m::channel::Data& ch : m::model::get().channels)
+	for (const m::channel::Data& ch : std::as_const(m::model::get().channels))
 		if (!ch.isInternal())
 			out.push_back(Data(ch));
 	return out;
@@ -65,9 +65,9 @@ void pushEvent_(m::eventDispatcher::Event e, Thread t)
 {
 	bool res = true;
 	if (t == Thread::MAIN)
-		res = m::eventDispatcher::UIevents.push(e);
+		res = m::eventDispatcher::pumpEvent(e);
 	else if (t == Thread::MIDI)
-		res = m::eventDispatcher::MidiEvents.push(e);
+		res = m::eventDispatcher::pumpMidiEvent(e);
 	else
 		assert(false);
 
@@ -58,6 +58,26 @@ namespace giada::c::main
 {
 namespace
 {
+/* followedBpm_
+Tempo recorded actions are scaled to while following an external clock, 0.0 
+when not following. */
+
+float followedBpm_ = 0.0f;
+
+/* -------------------------------------------------------------------------- */
+
+/* toBpmString_
+Returns bpm value 'f' as shown by the UI, with one decimal digit. */
+
+std::string toBpmString_(float f)
+{
+	float intpart;
+	float fracpart = std::round(std::modf(f, &intpart) * 10);
+	return std::to_string((int)intpart) + "." + std::to_string((int)fracpart);
+}
+
+/* -------------------------------------------------------------------------- */
+
 void setBpm_(float current, std::string s)
 {
 	if (current < G_MIN_BPM)
@@ -71,6 +91,8 @@ void setBpm_(float current, std::string s)
 		s       = G_MAX_BPM_STR;
 	}
 
+	endFollowBpm(); // Actions must be in sync with the current tempo first
+
 	float previous = m::clock::getBpm();
 	m::clock::setBpm(current);
 	m::recorderHandler::updateBpm(previous, current, m::clock::getQuantizerStep());
@@ -200,11 +222,38 @@ void setBpm(float f)
 	if (m::recManager::isRecordingInput())
 		return;
 
-	float       intpart;
-	float       fracpart = std::round(std::modf(f, &intpart) * 10);
-	std::string s        = std::to_string((int)intpart) + "." + std::to_string((int)fracpart);
+	setBpm_(f, toBpmString_(f));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void followBpm(float f)
+{
+	if (m::recManager::isRecordingInput())
+		return;
+
+	if (followedBpm_ == 0.0f)
+		followedBpm_ = m::clock::getBpm();
+	m::clock::setBpm(f);
+
+	if (G_MainWin != nullptr)
+		G_MainWin->mainTimer->setBpm(toBpmString_(m::clock::getBpm()).c_str());
+}
+
+/* -------------------------------------------------------------------------- */
+
+void endFollowBpm()
+{
+	if (followedBpm_ == 0.0f)
+		return;
+
+	m::recorderHandler::updateBpm(followedBpm_, m::clock::getBpm(), m::clock::getQuantizerStep());
+	followedBpm_ = 0.0f;
+
+	if (G_MainWin != nullptr)
+		u::gui::refreshActionEditor();
 
-	setBpm_(f, s);
+	u::log::print("[glue::endFollowBpm] actions rescaled to bpm=%f\n", m::clock::getBpm());
 }
 
 /* -------------------------------------------------------------------------- */
@@ -100,6 +100,20 @@ Sets bpm value. Usually called from the Jack callback or non-UI components. */
 
 void setBpm(float v);
 
+/* followBpm
+Sets bpm value while following an external clock. Unlike setBpm(), recorded 
+actions are left untouched, so that a tempo ramp doesn't degrade them step
+by step: they are rescaled only once, by endFollowBpm(). */
+
+void followBpm(float v);
+
+/* endFollowBpm
+Rescales recorded actions from the tempo they had when followBpm() was first
+called to the current one. Call it on transport changes of the external 
+clock. */
+
+void endFollowBpm();
+
 void setBeats(int beats, int bars);
 void quantize(int val);
 void clearAllSamples();
@@ -29,12 +29,24 @@
 #include <FL/Fl.H>
 #ifdef WITH_TESTS
 #define CATCH_CONFIG_RUNNER
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include "tests/audioBuffer.cpp"
+#include "tests/blockClock.cpp"
+#include "tests/cowVector.cpp"
+#include "tests/delayLockedLoop.cpp"
+#include "tests/envelope.cpp"
+#include "tests/idIndex.cpp"
+#include "tests/midiSync.cpp"
+#include "tests/mpmcQueue.cpp"
 #include "tests/recorder.cpp"
+#include "tests/renderPool.cpp"
+#include "tests/resamplerPool.cpp"
+#include "tests/sequencer.cpp"
 #include "tests/utils.cpp"
 #include "tests/wave.cpp"
 #include "tests/waveFx.cpp"
 #include "tests/waveManager.cpp"
+#include "tests/worker.cpp"
 #include <catch2/catch.hpp>
 #include <string>
 #include <vector>
@@ -1,6 +1,13 @@
 #include "../src/core/audioBuffer.h"
+#include "../src/core/simd.h"
+#ifdef WITH_VST
+#include "../src/deps/juce-config.h"
+#endif
 #include <catch2/catch.hpp>
 #include <memory>
+#include <random>
+#include <string>
+#include <vector>
 
 TEST_CASE("AudioBuffer")
 {
@@ -80,4 +87,240 @@ TEST_CASE("AudioBuffer")
 			REQUIRE(buffer[BUFFER_SIZE - 1][0] == (float)BUFFER_SIZE - 1);
 		}
 	}
+
+	SECTION("test planar conversion")
+	{
+		std::vector<float> left(BUFFER_SIZE), right(BUFFER_SIZE);
+		float*             planar[] = {left.data(), right.data()};
+
+		for (int i = 0; i < buffer.countFrames(); i++)
+		{
+			buffer[i][0] = (float)i;
+			buffer[i][1] = (float)-i;
+		}
+
+		buffer.toPlanar(planar);
+
+		REQUIRE(left[0] == 0.0f);
+		REQUIRE(left[128] == 128.0f);
+		REQUIRE(right[128] == -128.0f);
+		REQUIRE(right[BUFFER_SIZE - 1] == (float)-(BUFFER_SIZE - 1));
+
+		buffer.clear();
+		buffer.fromPlanar(planar);
+
+		for (int i = 0; i < buffer.countFrames(); i++)
+		{
+			REQUIRE(buffer[i][0] == (float)i);
+			REQUIRE(buffer[i][1] == (float)-i);
+		}
+	}
 }
+
+TEST_CASE("AudioBuffer - SIMD kernels")
+{
+	using namespace giada::m;
+
+	/* Odd sizes and offsets, so that both the vector body and the scalar tail
+	of each kernel get exercised, on unaligned memory. */
+
+	static const int SIZES[]   = {0, 1, 3, 4, 7, 8, 15, 17, 33, 1023};
+	static const int OFFSETS[] = {0, 1, 3};
+
+	std::mt19937                          rng(42);
+	std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+
+	auto makeData = [&](int size) {
+		std::vector<float> v(size);
+		for (float& f : v)
+			f = dist(rng);
+		return v;
+	};
+
+	const simd::Kernels& ref = simd::get(simd::Instructions::NONE);
+
+	simd::init();
+	REQUIRE(simd::get().instructions == simd::getAvailable().back());
+
+	for (simd::Instructions instr : simd::getAvailable())
+	{
+		const simd::Kernels& k = simd::get(instr);
+
+		REQUIRE(k.instructions == instr);
+
+		for (int size : SIZES)
+		{
+			for (int offset : OFFSETS)
+			{
+				const std::vector<float> src  = makeData(size + offset);
+				const std::vector<float> dest = makeData((size + offset) * 2);
+
+				/* Set/sum, stereo and mono */
+
+				for (bool mono : {false, true})
+				{
+					std::vector<float> a = dest, b = dest;
+
+					if (mono)
+					{
+						ref.setMonoToStereo(a.data() + offset, src.data() + offset, size, 0.7f, 0.3f, 0.9f);
+						k.setMonoToStereo(b.data() + offset, src.data() + offset, size, 0.7f, 0.3f, 0.9f);
+						ref.sumMonoToStereo(a.data() + offset, src.data() + offset, size, 0.5f, 0.8f, 0.1f);
+						k.sumMonoToStereo(b.data() + offset, src.data() + offset, size, 0.5f, 0.8f, 0.1f);
+					}
+					else
+					{
+						ref.set(a.data() + offset, src.data() + offset, size, 0.7f, 0.3f, 0.9f);
+						k.set(b.data() + offset, src.data() + offset, size, 0.7f, 0.3f, 0.9f);
+						ref.sum(a.data() + offset, src.data() + offset, size, 0.5f, 0.8f, 0.1f);
+						k.sum(b.data() + offset, src.data() + offset, size, 0.5f, 0.8f, 0.1f);
+					}
+
+					for (std::size_t i = 0; i < a.size(); i++)
+						REQUIRE(b[i] == Approx(a[i]));
+				}
+
+				/* Gain and clamp */
+
+				{
+					std::vector<float> a = src, b = src;
+
+					ref.applyGain(a.data() + offset, size, 0.6f);
+					k.applyGain(b.data() + offset, size, 0.6f);
+					ref.clamp(a.data() + offset, size, -0.5f, 0.5f);
+					k.clamp(b.data() + offset, size, -0.5f, 0.5f);
+
+					for (std::size_t i = 0; i < a.size(); i++)
+						REQUIRE(b[i] == Approx(a[i]));
+				}
+
+				/* Gain ramp, mono and stereo */
+
+				for (int channels : {1, 2})
+				{
+					std::vector<float> a = src, b = src;
+
+					ref.applyRamp(a.data() + offset, size, channels, 0.2f, 0.003f);
+					k.applyRamp(b.data() + offset, size, channels, 0.2f, 0.003f);
+
+					for (std::size_t i = 0; i < a.size(); i++)
+						REQUIRE(b[i] == Approx(a[i]));
+				}
+
+				/* Peak */
+
+				REQUIRE(k.getPeak(src.data() + offset, size) == ref.getPeak(src.data() + offset, size));
+
+				/* Master bus, with and without input and limiter */
+
+				for (bool inToOut : {false, true})
+				{
+					for (bool limit : {false, true})
+					{
+						std::vector<float> a = dest, b = dest;
+
+						const float*       in = inToOut ? src.data() + offset : nullptr;
+						const simd::Levels la = ref.finalize(a.data() + offset, in, size, 0.8f, limit);
+						const simd::Levels lb = k.finalize(b.data() + offset, in, size, 0.8f, limit);
+
+						for (std::size_t i = 0; i < a.size(); i++)
+							REQUIRE(b[i] == Approx(a[i]));
+						REQUIRE(lb.peak == la.peak);
+						REQUIRE(lb.rms == Approx(la.rms));
+						REQUIRE(la.peak == ref.getPeak(a.data() + offset, size));
+						if (limit)
+							REQUIRE(la.peak <= 1.0f);
+					}
+				}
+			}
+		}
+	}
+
+	SECTION("test copy with offsets")
+	{
+		static const int FRAMES = 1031;
+
+		AudioBuffer stereo(FRAMES, 2), mono(FRAMES, 1), out(FRAMES, 2);
+
+		for (int i = 0; i < FRAMES; i++)
+		{
+			stereo[i][0] = dist(rng);
+			stereo[i][1] = dist(rng);
+			mono[i][0]   = dist(rng);
+		}
+
+		const AudioBuffer::Pan pan = {0.25f, 0.75f};
+
+		out.set(stereo, 517, 3, 5, 0.5f, pan);
+		for (int i = 0; i < 517; i++)
+		{
+			REQUIRE(out[i + 5][0] == Approx(stereo[i + 3][0] * 0.5f * pan[0]));
+			REQUIRE(out[i + 5][1] == Approx(stereo[i + 3][1] * 0.5f * pan[1]));
+		}
+		REQUIRE(out[4][0] == 0.0f);
+		REQUIRE(out[522][0] == 0.0f);
+
+		out.clear();
+		out.sum(mono, 1001, 7, 13, 0.5f, pan);
+		for (int i = 0; i < 1001; i++)
+		{
+			REQUIRE(out[i + 13][0] == Approx(mono[i + 7][0] * 0.5f * pan[0]));
+			REQUIRE(out[i + 13][1] == Approx(mono[i + 7][0] * 0.5f * pan[1]));
+		}
+
+		/* Copy clamped to the destination size. */
+
+		out.set(stereo, -1, 0, FRAMES - 3);
+		REQUIRE(out[FRAMES - 1][1] == stereo[2][1]);
+	}
+}
+
+#if defined(WITH_VST) && defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+
+/* Hidden, run it with '--run-tests [benchmark]'. Compares the old per-sample
+interleaved <-> JUCE conversion against the planar one, for a round trip 
+through 1, 4 and 16 plug-in stacks. */
+
+TEST_CASE("AudioBuffer - JUCE bridge", "[.benchmark]")
+{
+	using namespace giada::m;
+
+	static const int BUFFER_SIZE = 512;
+
+	for (int stacks : {1, 4, 16})
+	{
+		std::vector<AudioBuffer>              buffers;
+		std::vector<juce::AudioBuffer<float>> juceBuffers;
+		for (int i = 0; i < stacks; i++)
+		{
+			buffers.emplace_back(BUFFER_SIZE, 2);
+			juceBuffers.emplace_back(2, BUFFER_SIZE);
+		}
+
+		BENCHMARK("per-sample, " + std::to_string(stacks) + " stacks")
+		{
+			for (int s = 0; s < stacks; s++)
+			{
+				for (int i = 0; i < BUFFER_SIZE; i++)
+					for (int j = 0; j < 2; j++)
+						juceBuffers[s].setSample(j, i, buffers[s][i][j]);
+				for (int i = 0; i < BUFFER_SIZE; i++)
+					for (int j = 0; j < 2; j++)
+						buffers[s][i][j] = juceBuffers[s].getSample(j, i);
+			}
+			return buffers[0][0][0];
+		};
+
+		BENCHMARK("planar, " + std::to_string(stacks) + " stacks")
+		{
+			for (int s = 0; s < stacks; s++)
+			{
+				buffers[s].toPlanar(juceBuffers[s].getArrayOfWritePointers());
+				buffers[s].fromPlanar(juceBuffers[s].getArrayOfReadPointers());
+			}
+			return buffers[0][0][0];
+		};
+	}
+}
+
+#endif
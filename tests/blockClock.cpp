@@ -0,0 +1,154 @@
+#include "../src/core/blockClock.h"
+#include "../src/core/const.h"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <random>
+#include <vector>
+
+/* Simulated MIDI loopback: a sender emits a message every 'period' frames of 
+stream time, while both the audio callbacks and the MIDI deliveries come in 
+with some scheduling jitter. Each message is placed at the block offset given 
+by the clock, then the distance from its ideal position in the output stream
+is measured. */
+
+TEST_CASE("BlockClock")
+{
+	using namespace giada;
+	using namespace std::chrono;
+
+	constexpr int   SAMPLE_RATE = 44100;
+	constexpr Frame BLOCK       = 256;
+	constexpr int   BLOCKS      = 2000;
+	constexpr Frame PERIOD      = 1000; // Frames between MIDI messages
+
+	const auto framesToTime = [](double f) {
+		return duration_cast<steady_clock::duration>(duration<double>(f / SAMPLE_RATE));
+	};
+
+	std::mt19937                     rng(42);
+	std::uniform_real_distribution<> audioJitter(0.0, BLOCK * 0.3);
+	std::uniform_real_distribution<> midiJitter(0.0, BLOCK * 0.2);
+
+	m::BlockClock clock;
+	clock.reset(SAMPLE_RATE);
+
+	const steady_clock::time_point origin = steady_clock::now();
+
+	SECTION("test offset range")
+	{
+		REQUIRE(clock.getOffset(origin) == 0); // No blocks yet
+
+		clock.tick(origin, BLOCK);
+
+		REQUIRE(clock.getOffset(origin) == 0);
+		REQUIRE(clock.getOffset(origin - seconds(10)) == 0);
+		REQUIRE(clock.getOffset(origin + framesToTime(100)) == Approx(100).margin(1));
+		REQUIRE(clock.getOffset(origin + seconds(10)) == BLOCK - 1);
+		REQUIRE(clock.getOffset({}) == 0);
+	}
+
+	SECTION("test jitter")
+	{
+		/* For each message: the ideal output frame is its send time plus one 
+		block (the fixed latency). 'placed' is where it lands with the clock, 
+		'naive' where it lands if applied at the start of the next block, as 
+		it happens without timestamps. */
+
+		Frame minError = BLOCK * 2;
+		Frame maxError = -BLOCK * 2;
+		Frame minNaive = BLOCK * 2;
+		Frame maxNaive = -BLOCK * 2;
+		Frame nextSend = PERIOD;
+
+		for (int b = 0; b < BLOCKS; b++)
+		{
+			const Frame blockStart = b * BLOCK;
+			clock.tick(origin + framesToTime(blockStart + audioJitter(rng)), BLOCK);
+
+			/* Messages sent during this block are applied with the next one,
+			i.e. placed relative to this block's start. Their timestamps are 
+			taken on the MIDI thread, which lags a bit behind the send time. */
+
+			while (nextSend < blockStart + BLOCK)
+			{
+				const double received = nextSend + midiJitter(rng);
+				const Frame  offset   = clock.getOffset(origin + framesToTime(received));
+				const Frame  placed   = blockStart + BLOCK + offset;
+				const Frame  ideal    = nextSend + BLOCK;
+
+				if (b > 10) // Let the clock settle first
+				{
+					minError = std::min(minError, placed - ideal);
+					maxError = std::max(maxError, placed - ideal);
+					minNaive = std::min(minNaive, blockStart + BLOCK - ideal);
+					maxNaive = std::max(maxNaive, blockStart + BLOCK - ideal);
+				}
+				nextSend += PERIOD;
+			}
+		}
+
+		INFO("clock jitter=" << maxError - minError << " frames, naive jitter=" << maxNaive - minNaive << " frames");
+
+		/* With the clock, the residual jitter comes mostly from the MIDI 
+		delivery, which a real driver timestamp removes as well. Without it the
+		jitter is about a whole block. */
+
+		REQUIRE(maxError - minError <= BLOCK * 0.3);
+		REQUIRE(maxNaive - minNaive >= BLOCK * 0.9);
+	}
+
+	SECTION("test position with different buffer sizes")
+	{
+		/* Replay the same timestamped input with different buffer sizes. Each
+		input is handled one or more blocks after the one it arrives in, as the
+		event thread does when it hops through the dispatcher queues. The 
+		position given by the clock must depend neither on the buffer size nor
+		on the delay, while the position of the block the input is handled in
+		(what recording at the current sequencer frame would give) does. */
+
+		const std::vector<Frame> inputs = {0, 100, 1000, 4321, 10007, 22050, 39999};
+		const std::vector<Frame> sizes  = {64, 256, 1000, 2048};
+
+		std::vector<std::vector<Frame>> positions;
+		std::vector<std::vector<Frame>> naives;
+
+		for (const Frame size : sizes)
+		{
+			m::BlockClock blockClock;
+			blockClock.reset(SAMPLE_RATE);
+
+			std::vector<Frame> position(inputs.size(), -1);
+			std::vector<Frame> naive(inputs.size(), -1);
+			std::size_t        handled = 0;
+
+			for (Frame start = 0; handled < inputs.size(); start += size)
+			{
+				blockClock.tick(origin + framesToTime(start), size, start);
+
+				for (std::size_t i = 0; i < inputs.size(); i++)
+				{
+					const Frame late = 1 + i % 3; // Blocks
+					if (position[i] != -1 || inputs[i] >= start + size - late * size)
+						continue;
+					position[i] = blockClock.getPosition(origin + framesToTime(inputs[i]));
+					naive[i]    = start;
+					handled++;
+				}
+			}
+
+			positions.push_back(position);
+			naives.push_back(naive);
+		}
+
+		for (std::size_t s = 0; s < sizes.size(); s++)
+			for (std::size_t i = 0; i < inputs.size(); i++)
+			{
+				INFO("buffer size=" << sizes[s] << ", input=" << inputs[i]);
+				REQUIRE(positions[s][i] == Approx(inputs[i]).margin(1));
+				REQUIRE(positions[s][i] == Approx(positions[0][i]).margin(1));
+			}
+
+		REQUIRE(naives[0] != naives[1]);
+	}
+}
@@ -0,0 +1,112 @@
+#include "../src/core/cowVector.h"
+#include "../src/core/swapper.h"
+#include <array>
+#include <catch2/catch.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST_CASE("CowVector")
+{
+	using namespace giada;
+
+	CowVector<std::string> a;
+	a.push_back("one");
+	a.push_back("two");
+	a.push_back("three");
+
+	CowVector<std::string> b = a;
+
+	SECTION("test sharing")
+	{
+		REQUIRE(b.size() == 3);
+		REQUIRE(a.isShared(0));
+		REQUIRE(&std::as_const(a)[1] == &std::as_const(b)[1]);
+	}
+
+	SECTION("test const access doesn't copy")
+	{
+		for (const std::string& s : std::as_const(b))
+			REQUIRE(!s.empty());
+		REQUIRE(a.isShared(0));
+		REQUIRE(a.isShared(1));
+		REQUIRE(a.isShared(2));
+	}
+
+	SECTION("test copy on write")
+	{
+		b[1] = "TWO";
+
+		REQUIRE(std::as_const(a)[1] == "two");
+		REQUIRE(std::as_const(b)[1] == "TWO");
+		REQUIRE(!a.isShared(1));
+		REQUIRE(a.isShared(0));
+		REQUIRE(a.isShared(2));
+	}
+
+	SECTION("test removeIf")
+	{
+		b.removeIf([](const std::string& s) { return s == "two"; });
+
+		REQUIRE(b.size() == 2);
+		REQUIRE(a.size() == 3);
+		REQUIRE(std::as_const(b)[1] == "three");
+		REQUIRE(a.isShared(2));
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+
+/* Hidden, run it with '--run-tests [benchmark]'. Measures the cost of swapping
+a layout after editing a single element, with a plain vector (full copy) and
+a CowVector (pointers copy plus one clone). */
+
+namespace
+{
+struct FakeChannel
+{
+	std::array<float, 64> params{};
+	std::string           name = "channel";
+};
+
+template <typename V>
+struct FakeLayout
+{
+	V channels;
+};
+} // namespace
+
+TEST_CASE("CowVector - swap", "[.benchmark]")
+{
+	using namespace giada;
+
+	for (int count : {16, 128, 1024})
+	{
+		Swapper<FakeLayout<std::vector<FakeChannel>>> plain;
+		Swapper<FakeLayout<CowVector<FakeChannel>>>   cow;
+
+		for (int i = 0; i < count; i++)
+		{
+			plain.get().channels.push_back(FakeChannel());
+			cow.get().channels.push_back(FakeChannel());
+		}
+		plain.swap();
+		cow.swap();
+
+		BENCHMARK("std::vector, " + std::to_string(count) + " channels")
+		{
+			plain.get().channels[0].params[0] += 1.0f;
+			plain.swap();
+		};
+
+		BENCHMARK("CowVector, " + std::to_string(count) + " channels")
+		{
+			cow.get().channels[0].params[0] += 1.0f;
+			cow.swap();
+		};
+	}
+}
+
+#endif
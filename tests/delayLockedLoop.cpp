@@ -0,0 +1,101 @@
+#include "../src/core/delayLockedLoop.h"
+#include "../src/core/const.h"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <random>
+
+/* Synthetic MIDI clock: 24 ticks per beat, each one delivered with up to 2 ms
+of random jitter, as a USB MIDI interface would do. */
+
+TEST_CASE("DelayLockedLoop")
+{
+	using namespace giada;
+
+	constexpr double JITTER = 0.002; // Seconds
+
+	std::mt19937                     rng(42);
+	std::uniform_real_distribution<> jitter(0.0, JITTER);
+
+	m::DelayLockedLoop dll(G_MIDI_SLAVE_BANDWIDTH);
+
+	auto toBpm = [](double period) { return 60.0 / (period * 24.0); };
+
+	SECTION("test lock")
+	{
+		REQUIRE_FALSE(dll.isLocked());
+		dll.tick(1.0);
+		REQUIRE_FALSE(dll.isLocked());
+		dll.tick(1.5);
+		REQUIRE(dll.isLocked());
+		REQUIRE(dll.getPeriod() == Approx(0.5));
+		REQUIRE(dll.getNextTime() == Approx(2.0));
+	}
+
+	SECTION("test steady tempo")
+	{
+		for (double bpm : {60.0, 120.0, 174.0, 300.0})
+		{
+			dll.reset();
+
+			const double period = 60.0 / (bpm * 24.0);
+			double       minBpm = G_MAX_BPM;
+			double       maxBpm = 0.0;
+			double       maxPhase = 0.0;
+
+			for (int i = 0; i < 24 * 64; i++) // 64 beats
+			{
+				dll.tick(i * period + jitter(rng));
+				if (i < 24 * 16) // Let it settle for 16 beats
+					continue;
+				minBpm   = std::min(minBpm, toBpm(dll.getPeriod()));
+				maxBpm   = std::max(maxBpm, toBpm(dll.getPeriod()));
+				maxPhase = std::max(maxPhase, std::abs(dll.getTime() - i * period - JITTER / 2));
+			}
+
+			INFO("bpm=" << bpm << " range=[" << minBpm << ", " << maxBpm << "] phase error=" << maxPhase);
+
+			/* Raw tick intervals swing by up to 2 ms, i.e. several BPM: the 
+			estimate must stay within 0.2%. */
+
+			REQUIRE(minBpm > bpm * 0.998);
+			REQUIRE(maxBpm < bpm * 1.002);
+			REQUIRE(maxPhase < JITTER);
+		}
+	}
+
+	SECTION("test tempo change")
+	{
+		/* 120 -> 130 BPM: the estimate must glide to the new tempo, with no 
+		large steps between consecutive ticks. */
+
+		const double period1 = 60.0 / (120.0 * 24.0);
+		const double period2 = 60.0 / (130.0 * 24.0);
+
+		double t = 0.0;
+		for (int i = 0; i < 24 * 16; i++, t += period1)
+			dll.tick(t + jitter(rng));
+
+		double prevBpm = toBpm(dll.getPeriod());
+		double maxStep = 0.0;
+		for (int i = 0; i < 24 * 32; i++, t += period2)
+		{
+			dll.tick(t + jitter(rng));
+			maxStep = std::max(maxStep, std::abs(toBpm(dll.getPeriod()) - prevBpm));
+			prevBpm = toBpm(dll.getPeriod());
+		}
+
+		INFO("final bpm=" << prevBpm << " max step=" << maxStep);
+		REQUIRE(prevBpm == Approx(130.0).margin(0.1));
+		REQUIRE(maxStep < 0.5);
+	}
+
+	SECTION("test interruption")
+	{
+		dll.tick(0.0);
+		dll.tick(0.02);
+		dll.tick(0.04);
+		dll.tick(10.0); // Clock stopped, then started again
+		REQUIRE_FALSE(dll.isLocked());
+	}
+}
@@ -0,0 +1,81 @@
+#include "../src/core/envelope.h"
+#include "../src/core/audioBuffer.h"
+#include <catch2/catch.hpp>
+#include <vector>
+
+/* Renders the same envelope over a buffer of ones, block by block, with 
+different buffer sizes: each frame must get the gain of the envelope at its 
+position in the loop, regardless of where the block boundaries fall. */
+
+TEST_CASE("Envelope")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	constexpr Frame LOOP = 10000;
+
+	Envelope envelope;
+
+	SECTION("test gain")
+	{
+		envelope.add(500, 1.0f);
+		envelope.add(1500, 0.0f);
+		envelope.add(1500, 0.8f); // Vertical
+		envelope.add(3500, 0.4f);
+
+		REQUIRE(envelope.getGain(0) == Approx(1.0f)); // Hold before first point
+		REQUIRE(envelope.getGain(1000) == Approx(0.5f));
+		REQUIRE(envelope.getGain(1499) == Approx(0.001f).margin(0.00001f));
+		REQUIRE(envelope.getGain(1500) == Approx(0.8f));
+		REQUIRE(envelope.getGain(2500) == Approx(0.6f));
+		REQUIRE(envelope.getGain(9000) == Approx(0.4f)); // Hold after last point
+	}
+
+	SECTION("test segments")
+	{
+		envelope.add(0, 1.0f);
+		envelope.add(1000, 0.0f);
+		envelope.add(1001, 1.0f);
+		envelope.add(4000, 0.25f);
+		envelope.add(LOOP - 1, 1.0f);
+
+		for (Frame size : {1, 64, 256, 1000, 4096})
+		{
+			AudioBuffer buffer(size, 2);
+
+			/* Start from the middle of the loop, so that some blocks wrap. */
+
+			for (Frame start = LOOP / 2; start < LOOP * 2; start += size)
+			{
+				for (Frame i = 0; i < size; i++)
+					buffer[i][0] = buffer[i][1] = 1.0f;
+
+				Frame covered = 0;
+				envelope.forEachSegment(start, size, LOOP, [&](const Envelope::Segment& s) {
+					REQUIRE(s.offset == covered);
+					REQUIRE(s.count > 0);
+					covered += s.count;
+					buffer.applyRamp(s.offset, s.count, s.gain, s.step);
+				});
+				REQUIRE(covered == size);
+
+				for (Frame i = 0; i < size; i++)
+				{
+					INFO("buffer size=" << size << ", frame=" << start + i);
+					const float expected = envelope.getGain((start + i) % LOOP);
+					REQUIRE(buffer[i][0] == Approx(expected).margin(0.0001f));
+					REQUIRE(buffer[i][1] == Approx(expected).margin(0.0001f));
+				}
+			}
+		}
+	}
+
+	SECTION("test empty")
+	{
+		bool called = false;
+		envelope.forEachSegment(0, 256, LOOP, [&](const Envelope::Segment&) { called = true; });
+
+		REQUIRE(envelope.isEmpty());
+		REQUIRE_FALSE(called);
+	}
+}
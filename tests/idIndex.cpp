@@ -0,0 +1,61 @@
+#include "../src/core/idIndex.h"
+#include <catch2/catch.hpp>
+#include <vector>
+
+TEST_CASE("IdIndex")
+{
+	using namespace giada;
+
+	struct Item
+	{
+		ID id;
+	};
+
+	auto getId = [](const Item& i) { return i.id; };
+
+	std::vector<Item> items = {{3}, {1}, {7}};
+	IdIndex           index;
+	index.rebuild(items, getId);
+
+	SECTION("test lookup")
+	{
+		REQUIRE(index.find(items, 3, getId) == 0);
+		REQUIRE(index.find(items, 1, getId) == 1);
+		REQUIRE(index.find(items, 7, getId) == 2);
+		REQUIRE(index.find(items, 2, getId) == -1);
+		REQUIRE(index.find(items, 100, getId) == -1);
+	}
+
+	SECTION("test stale index")
+	{
+		items.erase(items.begin());
+		items.push_back({9});
+
+		REQUIRE(index.find(items, 3, getId) == -1);
+		REQUIRE(index.find(items, 1, getId) == 0);
+		REQUIRE(index.find(items, 7, getId) == 1);
+		REQUIRE(index.find(items, 9, getId) == 2);
+	}
+
+	SECTION("test set")
+	{
+		items.push_back({9});
+		index.set(9, 3);
+
+		REQUIRE(index.find(items, 9, getId) == 3);
+		REQUIRE(index.find(items, 7, getId) == 2);
+
+		index.set(1 << 20, 4); // Ignored, too large
+
+		REQUIRE(index.find(items, 1 << 20, getId) == -1);
+	}
+
+	SECTION("test large IDs")
+	{
+		items.push_back({1 << 20});
+		index.rebuild(items, getId);
+
+		REQUIRE(index.find(items, 1 << 20, getId) == 3);
+		REQUIRE(index.find(items, 7, getId) == 2);
+	}
+}
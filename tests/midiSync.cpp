@@ -0,0 +1,115 @@
+#include "../src/core/midiSync.h"
+#include "../src/core/const.h"
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <vector>
+
+TEST_CASE("MidiSync")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	constexpr int SAMPLE_RATE = 44100;
+	constexpr int BEATS       = 4;
+
+	MidiSync sync;
+	sync.setup(SAMPLE_RATE, /*fps=*/25.0f);
+
+	/* render
+	Runs the generator over 'blocks' blocks and returns the absolute frame of 
+	each message of type 'type'. */
+
+	auto render = [&sync](int mode, int type, Frame bufferSize, Frame framesInBeat, int blocks) {
+		const Frame        framesInLoop = framesInBeat * BEATS;
+		std::vector<Frame> frames;
+		for (int b = 0; b < blocks; b++)
+			for (const MidiSync::Message& m : sync.advance(mode, (b * bufferSize) % framesInLoop, bufferSize, framesInLoop, framesInBeat))
+				if (m.b1 == type)
+					frames.push_back(b * bufferSize + m.delta);
+		return frames;
+	};
+
+	SECTION("test clock tick spacing")
+	{
+		/* Every tick must sit within one frame of its ideal position, across 
+		tempos and buffer sizes, loop boundaries included. */
+
+		for (float bpm : {60.0f, 120.0f, 137.5f, 333.0f, G_MAX_BPM})
+		{
+			for (Frame bufferSize : {64, 256, 1024, 4096})
+			{
+				const Frame  framesInBeat = static_cast<Frame>(SAMPLE_RATE * (60.0f / bpm));
+				const double ideal        = framesInBeat / 24.0;
+				const int    blocks       = (framesInBeat * BEATS * 3) / bufferSize;
+
+				const std::vector<Frame> ticks = render(MIDI_SYNC_CLOCK_M, MIDI_CLOCK, bufferSize, framesInBeat, blocks);
+
+				REQUIRE(ticks.size() >= static_cast<std::size_t>(blocks * bufferSize / ideal));
+
+				double maxError = 0.0;
+				for (std::size_t i = 0; i < ticks.size(); i++)
+					maxError = std::max(maxError, std::abs(ticks[i] - i * ideal));
+
+				INFO("bpm=" << bpm << " bufferSize=" << bufferSize << " maxError=" << maxError);
+				REQUIRE(maxError < 1.0);
+			}
+		}
+	}
+
+	SECTION("test clock tempo change")
+	{
+		/* Ticks stay on the beat grid of the new tempo right after the 
+		change. */
+
+		render(MIDI_SYNC_CLOCK_M, MIDI_CLOCK, 512, 22050, 10);
+
+		const Frame framesInBeat = 11025;
+		for (const MidiSync::Message& m : sync.advance(MIDI_SYNC_CLOCK_M, 0, 11025, 11025 * BEATS, framesInBeat))
+			REQUIRE(std::abs(m.delta - std::round(m.delta / (framesInBeat / 24.0)) * (framesInBeat / 24.0)) < 1.0);
+	}
+
+	SECTION("test MTC")
+	{
+		/* 25 fps: a quarter frame every 441 frames, exactly. */
+
+		const std::vector<Frame> quarters = render(MIDI_SYNC_MTC_M, MIDI_MTC_QUARTER, 1024, 22050, 200);
+
+		REQUIRE(quarters.size() == (200 * 1024) / 441 + 1);
+		for (std::size_t i = 0; i < quarters.size(); i++)
+			REQUIRE(quarters[i] == static_cast<Frame>(i * 441));
+	}
+
+	SECTION("test MTC timecode")
+	{
+		/* After two seconds the timecode reads 00:00:02:00. Collect the last 
+		full set of quarter frames. */
+
+		std::vector<int> data;
+		for (int b = 0; b < (SAMPLE_RATE * 2) / 441 + 8; b++)
+			for (const MidiSync::Message& m : sync.advance(MIDI_SYNC_MTC_M, 0, 441, 22050 * BEATS, 22050))
+				data.push_back(m.b2);
+
+		const std::size_t first = 2 * 25 * 4; // Quarter frame at 2 seconds
+		REQUIRE(data.size() >= first + 8);
+		REQUIRE(data[first + 0] == 0x00);       // Frames low
+		REQUIRE(data[first + 1] == 0x10);       // Frames high
+		REQUIRE(data[first + 2] == 0x22);       // Seconds low
+		REQUIRE(data[first + 3] == 0x30);       // Seconds high
+		REQUIRE(data[first + 7] == (0x70 | 2)); // Hours high, 25 fps
+
+		SECTION("test rewind")
+		{
+			sync.rewind();
+			const MidiSync::Messages& m = sync.advance(MIDI_SYNC_MTC_M, 0, 441, 22050 * BEATS, 22050);
+			REQUIRE(m.size() == 1);
+			REQUIRE(m.begin()->b2 == 0x00);
+			REQUIRE(m.begin()->delta == 0);
+		}
+	}
+
+	SECTION("test no sync")
+	{
+		REQUIRE(render(MIDI_SYNC_NONE, MIDI_CLOCK, 1024, 22050, 100).empty());
+		REQUIRE(render(MIDI_SYNC_CLOCK_S, MIDI_CLOCK, 1024, 22050, 100).empty());
+	}
+}
@@ -0,0 +1,105 @@
+#include "../src/core/mpmcQueue.h"
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <thread>
+#include <vector>
+
+TEST_CASE("MpmcQueue")
+{
+	using namespace giada::m;
+
+	SECTION("test push/pop")
+	{
+		MpmcQueue<int, 8> q;
+		int               v;
+
+		REQUIRE(q.pop(v) == false);
+
+		for (int i = 0; i < 8; i++)
+			REQUIRE(q.push(i) == true);
+		REQUIRE(q.push(8) == false);
+		REQUIRE(q.countOverflows() == 1);
+
+		for (int i = 0; i < 8; i++)
+		{
+			REQUIRE(q.pop(v) == true);
+			REQUIRE(v == i);
+		}
+		REQUIRE(q.pop(v) == false);
+	}
+
+	SECTION("test push with")
+	{
+		/* The item is built only if the push succeeds. */
+
+		MpmcQueue<int, 2> q;
+		int               made = 0;
+		int               v;
+
+		auto make = [&made]() { return ++made; };
+
+		REQUIRE(q.pushWith(make) == true);
+		REQUIRE(q.pushWith(make) == true);
+		REQUIRE(q.pushWith(make) == false);
+		REQUIRE(made == 2);
+
+		REQUIRE(q.pop(v) == true);
+		REQUIRE(v == 1);
+		REQUIRE(q.pop(v) == true);
+		REQUIRE(v == 2);
+	}
+
+	SECTION("test multiple producers and consumers")
+	{
+		constexpr int PRODUCERS = 4;
+		constexpr int CONSUMERS = 2;
+		constexpr int ITEMS     = 100000; // Per producer
+
+		MpmcQueue<int, 32>            q;
+		std::vector<std::vector<int>> popped(CONSUMERS);
+		std::atomic<int>              count(0);
+		std::vector<std::thread>      threads;
+
+		for (int p = 0; p < PRODUCERS; p++)
+			threads.emplace_back([&q, p]() {
+				for (int i = 0; i < ITEMS; i++)
+					while (!q.push(p * ITEMS + i))
+						std::this_thread::yield();
+			});
+
+		for (int c = 0; c < CONSUMERS; c++)
+			threads.emplace_back([&q, &popped, &count, c]() {
+				int v;
+				while (count.load() < PRODUCERS * ITEMS)
+				{
+					if (!q.pop(v))
+					{
+						std::this_thread::yield();
+						continue;
+					}
+					popped[c].push_back(v);
+					count++;
+				}
+			});
+
+		for (std::thread& t : threads)
+			t.join();
+
+		/* Each item must show up exactly once, and items from the same producer
+		must reach any consumer in order. */
+
+		std::vector<int> seen(PRODUCERS * ITEMS, 0);
+		for (const std::vector<int>& items : popped)
+		{
+			std::vector<int> last(PRODUCERS, -1);
+			for (int v : items)
+			{
+				seen[v]++;
+				REQUIRE(v % ITEMS > last[v / ITEMS]);
+				last[v / ITEMS] = v % ITEMS;
+			}
+		}
+		for (int s : seen)
+			REQUIRE(s == 1);
+	}
+}
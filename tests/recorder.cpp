@@ -1,8 +1,10 @@
 #include "../src/core/recorder.h"
+#include "../src/core/recorderHandler.h"
 #include "../src/core/action.h"
 #include "../src/core/const.h"
 #include "../src/core/types.h"
 #include <catch2/catch.hpp>
+#include <vector>
 
 TEST_CASE("recorder")
 {
@@ -64,3 +66,171 @@ TEST_CASE("recorder")
 		}
 	}
 }
+
+TEST_CASE("recorder - composite actions")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	recorder::init();
+
+	const MidiEvent on  = MidiEvent(MidiEvent::NOTE_ON, 0x00, 0x00);
+	const MidiEvent off = MidiEvent(MidiEvent::NOTE_OFF, 0x00, 0x00);
+
+	recorder::rec(/*channel=*/1, 100, 200, on, off);
+	recorder::rec(/*channel=*/2, 50, 150, on, off);
+	recorder::rec(/*channel=*/1, 10, 20, on, off);
+
+	std::vector<Action> actions = recorder::getActionsOnChannel(1);
+
+	SECTION("Test frame order")
+	{
+		REQUIRE(actions.size() == 4);
+		REQUIRE(actions[0].frame == 10);
+		REQUIRE(actions[1].frame == 20);
+		REQUIRE(actions[2].frame == 100);
+		REQUIRE(actions[3].frame == 200);
+	}
+
+	SECTION("Test siblings survive edits")
+	{
+		REQUIRE(actions[2].next != nullptr);
+		REQUIRE(actions[2].next->id == actions[3].id);
+		REQUIRE(actions[3].prev->id == actions[2].id);
+
+		recorder::deleteAction(actions[0].id, actions[1].id);
+		recorder::updateKeyFrames([](Frame f) { return f * 2; });
+
+		std::vector<Action> updated = recorder::getActionsOnChannel(1);
+
+		REQUIRE(updated.size() == 2);
+		REQUIRE(updated[0].frame == 200);
+		REQUIRE(updated[0].next->frame == 400);
+		REQUIRE(updated[1].prev->id == updated[0].id);
+	}
+
+	SECTION("Test frame lookup")
+	{
+		REQUIRE(recorder::getActionsOnFrame(50).size() == 1);
+		REQUIRE(recorder::getActionsOnFrame(51).empty());
+		REQUIRE(recorder::hasActions(/*channel=*/2, MidiEvent::NOTE_OFF));
+		REQUIRE(!recorder::hasActions(/*channel=*/3));
+	}
+
+	SECTION("Test volume envelope")
+	{
+		const ID ch = 5;
+
+		recorder::rec(ch, 0, MidiEvent(MidiEvent::ENVELOPE, 0, G_MAX_VELOCITY));
+		recorder::rec(ch, 1000, MidiEvent(MidiEvent::ENVELOPE, 0, 0));
+
+		const auto& envelopes = recorder::getTimeline().envelopes;
+
+		REQUIRE(envelopes.count(ch) == 1);
+		REQUIRE(envelopes.count(/*channel=*/0) == 0);
+		REQUIRE(envelopes.at(ch).getGain(0) == Approx(1.0f));
+		REQUIRE(envelopes.at(ch).getGain(500) == Approx(0.5f));
+		REQUIRE(envelopes.at(ch).getGain(2000) == Approx(0.0f));
+
+		/* Edit the boundary point in place, as the action editor does. */
+
+		const Action first = recorder::getClosestAction(ch, 0, MidiEvent::ENVELOPE);
+		recorder::updateEvent(first.id, MidiEvent(MidiEvent::ENVELOPE, 0, 0));
+
+		REQUIRE(recorder::getTimeline().envelopes.at(ch).getGain(0) == Approx(0.0f));
+		REQUIRE(recorder::getTimeline().envelopes.at(ch).getGain(500) == Approx(0.0f));
+
+		recorder::clearActions(ch, MidiEvent::ENVELOPE);
+
+		REQUIRE(recorder::getTimeline().envelopes.count(ch) == 0);
+	}
+
+	recorder::clearAll();
+}
+
+TEST_CASE("recorderHandler - consolidate")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	/* No recorderHandler::init() here: it would start the background 
+	consolidator, while these tests drain the capture ring by hand. */
+
+	recorder::init();
+
+	auto on  = [](int note) { return MidiEvent(MidiEvent::NOTE_ON, note, 0x3F); };
+	auto off = [](int note) { return MidiEvent(MidiEvent::NOTE_OFF, note, 0x00); };
+
+	SECTION("Test overlapping notes")
+	{
+		recorderHandler::liveRec(/*channel=*/1, on(60), 0);
+		recorderHandler::liveRec(/*channel=*/1, on(60), 10);
+		recorderHandler::liveRec(/*channel=*/2, on(60), 15);
+		recorderHandler::liveRec(/*channel=*/1, off(60), 20);
+		recorderHandler::liveRec(/*channel=*/1, off(60), 30);
+		recorderHandler::liveRec(/*channel=*/1, off(61), 40);
+
+		REQUIRE(recorderHandler::consolidate().size() == 2);
+
+		std::vector<Action> actions = recorder::getActionsOnChannel(1);
+
+		REQUIRE(actions.size() == 5);
+		REQUIRE(actions[0].next->frame == 20);
+		REQUIRE(actions[1].next->frame == 30);
+		REQUIRE(actions[4].prev == nullptr);
+		REQUIRE(recorder::getActionsOnChannel(2)[0].next == nullptr);
+	}
+
+	SECTION("Test long takes")
+	{
+		/* 100k events: 50k notes on 128 (channel, key) pairs, since the key
+		also determines the channel. All notes start before the first one ends,
+		so each pair holds about 390 overlapping notes, paired in order. */
+
+		const int notes = 50000;
+
+		const int dropped = recorderHandler::countDroppedLiveRecs();
+
+		for (int i = 0; i < notes * 2; i++)
+		{
+			const int n = i % notes;
+			if (i < notes)
+				recorderHandler::liveRec(1 + n % 16, on(n % 128), i * 4);
+			else
+				recorderHandler::liveRec(1 + n % 16, off(n % 128), i * 4);
+			if (i % 1000 == 0)
+				recorderHandler::drainLiveRecs();
+		}
+
+		REQUIRE(recorderHandler::consolidate().size() == 16);
+		REQUIRE(recorderHandler::countDroppedLiveRecs() == dropped);
+
+		std::size_t paired = 0;
+		recorder::forEachAction([&](const Action& a) {
+			if (a.event.getStatus() != MidiEvent::NOTE_ON)
+				return;
+			REQUIRE(a.next != nullptr);
+			REQUIRE(a.next->event.getNote() == a.event.getNote());
+			REQUIRE(a.next->channelId == a.channelId);
+			REQUIRE(a.next->frame - a.frame == notes * 4);
+			paired++;
+		});
+		REQUIRE(paired == notes);
+	}
+
+	SECTION("Test capture ring overflow")
+	{
+		const int dropped = recorderHandler::countDroppedLiveRecs();
+
+		/* The ring holds G_MAX_LIVE_RECS - 1 actions: the last one gets lost. */
+
+		for (int i = 0; i < G_MAX_LIVE_RECS; i++)
+			recorderHandler::liveRec(1, on(60), i);
+
+		REQUIRE(recorderHandler::countDroppedLiveRecs() == dropped + 1);
+		REQUIRE(recorderHandler::consolidate().size() == 1);
+		REQUIRE(recorder::getActionsOnChannel(1).size() == G_MAX_LIVE_RECS - 1);
+	}
+
+	recorder::clearAll();
+}
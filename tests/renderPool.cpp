@@ -0,0 +1,75 @@
+#include "../src/core/renderPool.h"
+#include <array>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+TEST_CASE("RenderPool")
+{
+	using namespace giada;
+
+	static const std::size_t CHANNELS = 37;
+	static const std::size_t FRAMES   = 256;
+	static const int         BLOCKS   = 200;
+
+	SECTION("test each job runs once per batch")
+	{
+		std::vector<int> calls(CHANNELS, 0);
+		RenderPool       pool;
+		pool.start(4, [&calls](std::size_t i) { calls[i]++; });
+
+		for (int b = 0; b < BLOCKS; b++)
+			pool.run(CHANNELS);
+		pool.stop();
+
+		for (int c : calls)
+			REQUIRE(c == BLOCKS);
+	}
+
+	SECTION("test bit-exact output")
+	{
+		/* Same scheme as the mixer: each job renders its own channel buffer, 
+		with its own state carried across blocks, then buffers are summed into
+		'out' serially. The result must not depend on the number of threads. */
+
+		auto render = [](int threads) {
+			std::vector<std::vector<float>> buffers(CHANNELS, std::vector<float>(FRAMES));
+			std::vector<double>             phases(CHANNELS, 0.0);
+			std::vector<float>              out;
+
+			RenderPool pool;
+			pool.start(threads, [&buffers, &phases](std::size_t i) {
+				const double step = 0.001 * (i + 1);
+				const float  gain = 1.0f / (i + 1);
+				for (float& f : buffers[i])
+				{
+					f = static_cast<float>(std::sin(phases[i])) * gain;
+					phases[i] += step;
+				}
+			});
+
+			for (int b = 0; b < BLOCKS; b++)
+			{
+				std::vector<float> block(FRAMES, 0.0f);
+				pool.run(CHANNELS);
+				for (const std::vector<float>& buffer : buffers)
+					for (std::size_t f = 0; f < FRAMES; f++)
+						block[f] += buffer[f] * 0.7f;
+				out.insert(out.end(), block.begin(), block.end());
+			}
+			pool.stop();
+			return out;
+		};
+
+		const std::vector<float> serial = render(1);
+
+		for (int threads : {2, 4, 8})
+		{
+			const std::vector<float> parallel = render(threads);
+
+			REQUIRE(parallel.size() == serial.size());
+			REQUIRE(std::memcmp(parallel.data(), serial.data(), serial.size() * sizeof(float)) == 0);
+		}
+	}
+}
@@ -0,0 +1,70 @@
+#include "../src/core/channels/waveReader.h"
+#include "../src/core/resamplerPool.h"
+#include <catch2/catch.hpp>
+#include <string>
+#include <vector>
+
+TEST_CASE("resamplerPool")
+{
+	using namespace giada::m;
+
+	resamplerPool::init(4);
+
+	SECTION("test assignment")
+	{
+		SRC_STATE* a = resamplerPool::get(1);
+		SRC_STATE* b = resamplerPool::get(2);
+
+		REQUIRE(a != nullptr);
+		REQUIRE(a != b);
+		REQUIRE(resamplerPool::get(1) == a);
+		REQUIRE(resamplerPool::countFree() == 2);
+	}
+
+	SECTION("test release")
+	{
+		SRC_STATE* a = resamplerPool::get(1);
+		resamplerPool::release(1);
+
+		REQUIRE(resamplerPool::countFree() == 4);
+		REQUIRE(resamplerPool::get(3) == a);
+	}
+
+	SECTION("test growth")
+	{
+		for (giada::ID id = 1; id <= 6; id++)
+			REQUIRE(resamplerPool::get(id) != nullptr);
+		REQUIRE(resamplerPool::countFree() == 0);
+	}
+
+	resamplerPool::releaseAll();
+}
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+
+/* Hidden, run it with '--run-tests [benchmark]'. Cost of copying the wave 
+readers of 200 sample channels, as it happens on each model swap. */
+
+TEST_CASE("resamplerPool - copy", "[.benchmark]")
+{
+	using namespace giada::m;
+
+	resamplerPool::init(200);
+
+	std::vector<WaveReader> readers;
+	for (giada::ID id = 1; id <= 200; id++)
+		readers.push_back(WaveReader(id));
+	std::vector<WaveReader> copy = readers;
+
+	BENCHMARK("copy 200 readers")
+	{
+		copy = readers;
+		return copy.size();
+	};
+
+	resamplerPool::releaseAll();
+}
+
+#endif
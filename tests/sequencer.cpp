@@ -0,0 +1,154 @@
+#include "../src/core/sequencer.h"
+#include "../src/core/clock.h"
+#include "../src/core/conf.h"
+#include "../src/core/model/model.h"
+#include "../src/core/recorder.h"
+#include <catch2/catch.hpp>
+#include <string>
+#include <vector>
+
+TEST_CASE("sequencer")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	model::init();
+	clock::init(conf::conf.samplerate, conf::conf.midiTCfps);
+	recorder::init();
+
+	const Frame framesInLoop = clock::getFramesInLoop();
+	const Frame framesInBeat = clock::getFramesInBeat();
+	const Frame bufferSize   = 1024;
+
+	auto advance = [](Frame bufferSize, bool withActions = true) {
+		const sequencer::EventBuffer& events = sequencer::advance(bufferSize, withActions);
+		return std::vector<sequencer::Event>(events.begin(), events.end());
+	};
+
+	recorder::rec(/*channel=*/1, 10, MidiEvent(MidiEvent::NOTE_ON, 0x00, 0x00));
+	recorder::rec(/*channel=*/1, framesInBeat, MidiEvent(MidiEvent::NOTE_ON, 0x00, 0x00));
+	recorder::rec(/*channel=*/1, framesInLoop - 1, MidiEvent(MidiEvent::NOTE_OFF, 0x00, 0x00));
+
+	SECTION("Test actions at the beginning of the loop")
+	{
+		const std::vector<sequencer::Event> events = advance(bufferSize);
+
+		REQUIRE(events.size() == 2);
+		REQUIRE(events[0].type == sequencer::EventType::FIRST_BEAT);
+		REQUIRE(events[0].delta == 0);
+		REQUIRE(events[1].type == sequencer::EventType::ACTIONS);
+		REQUIRE(events[1].delta == 10);
+	}
+
+	SECTION("Test actions across the loop boundary")
+	{
+		clock::advance(framesInLoop - 10);
+
+		const std::vector<sequencer::Event> events = advance(bufferSize);
+
+		REQUIRE(events.size() == 3);
+		REQUIRE(events[0].type == sequencer::EventType::ACTIONS);
+		REQUIRE(events[0].global == framesInLoop - 1);
+		REQUIRE(events[0].delta == 9);
+		REQUIRE(events[1].type == sequencer::EventType::FIRST_BEAT);
+		REQUIRE(events[1].delta == 10);
+		REQUIRE(events[2].delta == 20);
+	}
+
+	SECTION("Test actions skipped")
+	{
+		const std::vector<sequencer::Event> events = advance(bufferSize, /*withActions=*/false);
+
+		REQUIRE(events.size() == 1);
+		REQUIRE(events[0].type == sequencer::EventType::FIRST_BEAT);
+	}
+
+	SECTION("Test bars not aligned to beats")
+	{
+		/* Frames in bar are not a multiple of frames in beat here: each bar must
+		be reported anyway, exactly where the per-frame check would find it. */
+
+		auto test = [&](float bpm, int beats, int bars) {
+			clock::setBpm(bpm);
+			clock::setBeats(beats, bars);
+			clock::rewind();
+
+			const Frame loop = clock::getFramesInLoop();
+			const Frame bar  = clock::getFramesInBar();
+			const Frame beat = clock::getFramesInBeat();
+
+			REQUIRE(bar % beat != 0);
+
+			std::vector<Frame> expected, found;
+			for (Frame f = bar; f < loop; f += bar)
+				expected.push_back(f);
+
+			for (Frame f = 0; f < loop; f += bufferSize)
+				for (const sequencer::Event& e : advance(bufferSize))
+					if (e.type == sequencer::EventType::BAR && e.global < loop)
+						found.push_back(e.global);
+
+			REQUIRE(found == expected);
+		};
+
+		test(120.0f, 7, 3);
+		test(121.3f, 4, 2);
+
+		clock::setBpm(G_DEFAULT_BPM);
+		clock::setBeats(G_DEFAULT_BEATS, G_DEFAULT_BARS);
+	}
+
+	clock::rewind();
+	recorder::clearAll();
+}
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+
+/* Hidden, run it with '--run-tests [benchmark]'. Cost of parsing one block with
+an increasing amount of recorded actions. */
+
+TEST_CASE("sequencer - advance", "[.benchmark]")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	model::init();
+	clock::init(conf::conf.samplerate, conf::conf.midiTCfps);
+	recorder::init();
+
+	const Frame framesInLoop = clock::getFramesInLoop();
+
+	for (int count : {0, 100, 100000})
+	{
+		{
+			std::vector<Action> actions;
+			for (int i = 0; i < count; i++)
+			{
+				Frame f = static_cast<Frame>((static_cast<long long>(i) * framesInLoop) / count);
+				actions.push_back(recorder::makeAction(0, /*channel=*/1, f, MidiEvent(MidiEvent::NOTE_ON, 0x00, 0x00)));
+			}
+
+			model::DataLock lock;
+			model::getAll<model::Actions>().clear();
+			model::getAll<model::Actions>().insert(actions);
+			recorder::refreshTimeline();
+		}
+
+		/* The sequencer's event buffer has a limited capacity: use small 
+		blocks with 100k actions. */
+
+		const Frame bufferSize = count > 1000 ? 32 : 1024;
+
+		BENCHMARK(std::to_string(count) + " actions, block of " + std::to_string(bufferSize))
+		{
+			return sequencer::advance(bufferSize).size();
+		};
+	}
+
+	clock::rewind();
+	recorder::clearAll();
+}
+
+#endif
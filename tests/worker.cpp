@@ -0,0 +1,44 @@
+#include "../src/core/worker.h"
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <thread>
+
+TEST_CASE("Worker")
+{
+	using namespace giada;
+	using namespace std::chrono;
+
+	std::atomic<int> calls(0);
+	Worker           worker;
+
+	SECTION("test signalled wakeup")
+	{
+		/* With a 10 seconds timeout, the only way to get a call within a 
+		second is a notification. */
+
+		worker.startSignalled([&calls]() { calls++; }, /*timeout=*/10000);
+
+		const auto start = steady_clock::now();
+		worker.notify();
+		while (calls.load() == 0 && steady_clock::now() - start < seconds(5))
+			std::this_thread::yield();
+
+		REQUIRE(calls.load() == 1);
+		REQUIRE(steady_clock::now() - start < seconds(1));
+	}
+
+	SECTION("test coalescing")
+	{
+		worker.startSignalled([&calls]() { calls++; }, /*timeout=*/10000, /*coalesce=*/200);
+
+		for (int i = 0; i < 10; i++)
+			worker.notify();
+		std::this_thread::sleep_for(milliseconds(500));
+
+		REQUIRE(calls.load() >= 1);
+		REQUIRE(calls.load() <= 2);
+	}
+
+	worker.stop();
+}